@@ -0,0 +1,143 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ai.h"
+
+void init_ai_scheduler(AiScheduler *scheduler) {
+    scheduler->enemies = NULL;
+    scheduler->lod = NULL;
+    scheduler->lastUpdate = NULL;
+    scheduler->count = 0;
+    scheduler->capacity = 0;
+    scheduler->frame = 0;
+    scheduler->order = NULL;
+    scheduler->bucketCapacity = 0;
+    memset(scheduler->slotStart, 0, sizeof(scheduler->slotStart));
+    memset(scheduler->dirty, 0, sizeof(scheduler->dirty));
+}
+
+int ai_add_enemy(AiScheduler *scheduler, Enemy *enemy) {
+    if (scheduler->count == scheduler->capacity) {
+        int capacity = scheduler->capacity ? scheduler->capacity * 2 : 16;
+        Enemy **enemies = realloc(scheduler->enemies, capacity * sizeof(Enemy *));
+        if (enemies) scheduler->enemies = enemies;
+        Uint8 *lod = realloc(scheduler->lod, capacity * sizeof(Uint8));
+        if (lod) scheduler->lod = lod;
+        Uint32 *lastUpdate = realloc(scheduler->lastUpdate, capacity * sizeof(Uint32));
+        if (lastUpdate) scheduler->lastUpdate = lastUpdate;
+        int bucketCapacity = (capacity + AI_BUCKETS - 1) / AI_BUCKETS;
+        int *order = realloc(scheduler->order, bucketCapacity * AI_BUCKETS * sizeof(int));
+        if (order) scheduler->order = order;
+        if (!enemies || !lod || !lastUpdate || !order) {
+            printf("Out of memory for the AI scheduler\n");
+            return 0;
+        }
+        scheduler->capacity = capacity;
+        
+        // Bucket ranges moved: every list is rebuilt on the next update
+        scheduler->bucketCapacity = bucketCapacity;
+        memset(scheduler->dirty, 1, sizeof(scheduler->dirty));
+    }
+    
+    int i = scheduler->count++;
+    scheduler->enemies[i] = enemy;
+    scheduler->lod[i] = AI_LOD_FULL; // Until its bucket comes up
+    scheduler->lastUpdate[i] = scheduler->frame;
+    scheduler->dirty[i % AI_BUCKETS] = 1;
+    return 1;
+}
+
+// LOD from the distance between the enemy's box and the view
+static AiLod classer_ennemi(const Enemy *enemy, const Camera *camera) {
+    const WorldRect *p = &enemy->position;
+    int dx = 0, dy = 0;
+    if (p->x + p->w <= camera->x) dx = camera->x - (p->x + p->w);
+    else if (p->x >= camera->x + camera->w) dx = p->x - (camera->x + camera->w);
+    if (p->y + p->h <= camera->y) dy = camera->y - (p->y + p->h);
+    else if (p->y >= camera->y + camera->h) dy = p->y - (camera->y + camera->h);
+    
+    if (dx == 0 && dy == 0) return AI_LOD_FULL;
+    if (dx < AI_NEAR_MARGIN && dy < AI_NEAR_MARGIN) return AI_LOD_NEAR;
+    return AI_LOD_FAR;
+}
+
+// List of an enemy: near enemies are split by the frames they update on
+static int slot_ennemi(int i, AiLod lod) {
+    switch (lod) {
+        case AI_LOD_FULL: return AI_SLOT_FULL;
+        case AI_LOD_NEAR: return AI_SLOT_NEAR + i % AI_NEAR_PERIOD;
+        default:          return AI_SLOT_FAR;
+    }
+}
+
+// Rebuild a bucket's lists (counting sort by slot), reclassifying it first if camera is set
+static void classer_bucket(AiScheduler *scheduler, int bucket, const Camera *camera) {
+    int *start = scheduler->slotStart[bucket];
+    int counts[AI_SLOTS] = {0};
+    for (int i = bucket; i < scheduler->count; i += AI_BUCKETS) {
+        if (camera) scheduler->lod[i] = classer_ennemi(scheduler->enemies[i], camera);
+        counts[slot_ennemi(i, scheduler->lod[i])]++;
+    }
+    
+    start[0] = 0;
+    for (int k = 0; k < AI_SLOTS; k++) {
+        start[k + 1] = start[k] + counts[k];
+        counts[k] = start[k];
+    }
+    int *order = scheduler->order + bucket * scheduler->bucketCapacity;
+    for (int i = bucket; i < scheduler->count; i += AI_BUCKETS) {
+        order[counts[slot_ennemi(i, scheduler->lod[i])]++] = i;
+    }
+    scheduler->dirty[bucket] = 0;
+}
+
+// Run one enemy's AI; moves are scaled by the frames skipped, capped after a long sleep
+static void mettre_a_jour_ennemi(AiScheduler *scheduler, int i, WorldRect player_pos, const CollisionMap *map, TimerWheel *timers) {
+    int frames = (int)(scheduler->frame - scheduler->lastUpdate[i]);
+    if (frames > AI_BUCKETS) frames = AI_BUCKETS;
+    scheduler->lastUpdate[i] = scheduler->frame;
+    
+    if (scheduler->lod[i] == AI_LOD_FAR) {
+        moveEnemy(scheduler->enemies[i], map, frames); // Out of reach of the player: patrol only
+    } else {
+        moveEnemyAI(scheduler->enemies[i], player_pos, map, frames, timers);
+    }
+}
+
+// Run every enemy of one list of one bucket
+static void mettre_a_jour_slot(AiScheduler *scheduler, int bucket, int slot, WorldRect player_pos, const CollisionMap *map, TimerWheel *timers) {
+    const int *order = scheduler->order + bucket * scheduler->bucketCapacity;
+    for (int k = scheduler->slotStart[bucket][slot]; k < scheduler->slotStart[bucket][slot + 1]; k++) {
+        mettre_a_jour_ennemi(scheduler, order[k], player_pos, map, timers);
+    }
+}
+
+// Cost per frame: the on-screen enemies, the near ones due this frame and one bucket,
+// whatever the number of far enemies in the world
+void ai_update(AiScheduler *scheduler, const Camera *camera, WorldRect player_pos, const CollisionMap *map, TimerWheel *timers) {
+    Uint32 frame = ++scheduler->frame;
+    int bucket = frame % AI_BUCKETS;
+    
+    // Reclassify one bucket per frame; the buckets that just gained enemies only get
+    // their lists rebuilt (new enemies stay at full LOD until their bucket comes up)
+    for (int b = 0; b < AI_BUCKETS; b++) {
+        if (b == bucket) classer_bucket(scheduler, b, camera);
+        else if (scheduler->dirty[b]) classer_bucket(scheduler, b, NULL);
+    }
+    
+    // Near enemy i updates when (i + frame) % AI_NEAR_PERIOD == 0
+    int nearSlot = AI_SLOT_NEAR + (AI_NEAR_PERIOD - frame % AI_NEAR_PERIOD) % AI_NEAR_PERIOD;
+    for (int b = 0; b < AI_BUCKETS; b++) {
+        mettre_a_jour_slot(scheduler, b, AI_SLOT_FULL, player_pos, map, timers);
+        mettre_a_jour_slot(scheduler, b, nearSlot, player_pos, map, timers);
+    }
+    mettre_a_jour_slot(scheduler, bucket, AI_SLOT_FAR, player_pos, map, timers);
+}
+
+void free_ai_scheduler(AiScheduler *scheduler) {
+    free(scheduler->enemies);
+    free(scheduler->lod);
+    free(scheduler->lastUpdate);
+    free(scheduler->order);
+    init_ai_scheduler(scheduler);
+}
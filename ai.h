@@ -0,0 +1,49 @@
+#ifndef AI_H
+#define AI_H
+
+#include <SDL/SDL.h>
+#include "camera.h"
+#include "collision.h"
+#include "ennemie.h"
+#include "timer.h"
+
+// Level of detail of an enemy's AI, from its distance to the view
+typedef enum {
+    AI_LOD_FULL,                  // On screen: chase logic every frame
+    AI_LOD_NEAR,                  // Within AI_NEAR_MARGIN of the view: chase logic every AI_NEAR_PERIOD frames
+    AI_LOD_FAR                    // Further away: patrol only, every AI_BUCKETS frames
+} AiLod;
+
+#define AI_NEAR_MARGIN 256        // Pixels around the view still counted as near
+#define AI_NEAR_PERIOD 2
+#define AI_BUCKETS 8              // Round-robin buckets: each frame reclassifies and ticks one of them
+
+// Per bucket lists: on-screen enemies, near enemies by update phase (i % AI_NEAR_PERIOD), far enemies
+#define AI_SLOT_FULL 0
+#define AI_SLOT_NEAR 1
+#define AI_SLOT_FAR (AI_SLOT_NEAR + AI_NEAR_PERIOD)
+#define AI_SLOTS (AI_SLOT_FAR + 1)
+
+// Enemies registered for AI updates. Enemy i belongs to bucket i % AI_BUCKETS, so far
+// enemies and LOD reclassification are spread evenly over the frames. Each bucket keeps
+// its enemies sorted by LOD slot, so a frame only visits the enemies it updates.
+typedef struct {
+    Enemy **enemies;
+    Uint8 *lod;                   // AiLod of each enemy
+    Uint32 *lastUpdate;           // Frame of each enemy's last update
+    int count;
+    int capacity;
+    Uint32 frame;
+    
+    int *order;                   // Bucket b's enemy indices start at order[b * bucketCapacity]
+    int bucketCapacity;
+    int slotStart[AI_BUCKETS][AI_SLOTS + 1]; // Slot k of bucket b is [slotStart[b][k], slotStart[b][k + 1]) in its range
+    Uint8 dirty[AI_BUCKETS];      // Bucket gained enemies since its lists were built
+} AiScheduler;
+
+void init_ai_scheduler(AiScheduler *scheduler);
+int ai_add_enemy(AiScheduler *scheduler, Enemy *enemy); // Returns 0 if out of memory
+void ai_update(AiScheduler *scheduler, const Camera *camera, WorldRect player_pos, const CollisionMap *map, TimerWheel *timers);
+void free_ai_scheduler(AiScheduler *scheduler);
+
+#endif // AI_H
@@ -1,4 +1,5 @@
 #include "assets.h"
+#include "atlas.h"
 #include <stdio.h>
 #include <string.h> // For strstr function
 
@@ -6,6 +7,12 @@
 SDL_Surface* load_asset_image(const char* path) {
     SDL_Surface* loaded_image = NULL;
     
+    // Packed images are served from the atlas pages decoded at startup
+    SDL_Surface* atlas_view = atlas_lookup(path);
+    if (atlas_view != NULL) {
+        return atlas_view;
+    }
+    
     // Check if file exists before trying to load it
     FILE *file = fopen(path, "rb");
     if (file != NULL) {
@@ -56,6 +63,71 @@ SDL_Surface* load_asset_image(const char* path) {
     }
 }
 
+// Helper function to load an image while keeping its palette
+// 8-bit indexed images stay 8-bit so their palette can be swapped (outfit variants);
+// other images are converted like load_asset_image
+SDL_Surface* load_asset_image_indexed(const char* path) {
+    SDL_Surface* loaded_image = NULL;
+    
+    FILE *file = fopen(path, "rb");
+    if (file != NULL) {
+        fclose(file);
+        loaded_image = IMG_Load(path);
+    }
+    
+    if (loaded_image == NULL) {
+        printf("Unable to load indexed image %s: %s\n", path, IMG_GetError());
+        return NULL;
+    }
+    
+    if (loaded_image->format->BitsPerPixel == 8 && loaded_image->format->palette) {
+        // Palette index 0 is transparent unless the PNG defines its own transparency
+        if (!(loaded_image->flags & SDL_SRCCOLORKEY)) {
+            SDL_SetColorKey(loaded_image, SDL_SRCCOLORKEY, 0);
+        }
+        return loaded_image;
+    }
+    
+    SDL_Surface* optimized_image = SDL_DisplayFormatAlpha(loaded_image);
+    if (optimized_image != NULL) {
+        SDL_FreeSurface(loaded_image);
+        return optimized_image;
+    }
+    return loaded_image;
+}
+
+// Helper function to load a palette file (JASC-PAL format, as exported by most pixel art editors)
+int load_asset_palette(const char* path, SDL_Color* colors, int max_colors) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        printf("Unable to load palette %s\n", path);
+        return 0;
+    }
+    
+    char header[16];
+    int version, count = 0;
+    if (fscanf(file, "%15s %d %d", header, &version, &count) != 3 || strcmp(header, "JASC-PAL") != 0) {
+        printf("Invalid palette file %s (expected JASC-PAL)\n", path);
+        fclose(file);
+        return 0;
+    }
+    
+    if (count > max_colors) count = max_colors;
+    
+    int loaded = 0;
+    int r, g, b;
+    while (loaded < count && fscanf(file, "%d %d %d", &r, &g, &b) == 3) {
+        colors[loaded].r = r;
+        colors[loaded].g = g;
+        colors[loaded].b = b;
+        colors[loaded].unused = 0;
+        loaded++;
+    }
+    
+    fclose(file);
+    return loaded;
+}
+
 // Helper function to load a font asset
 TTF_Font* load_asset_font(const char* path, int size) {
     // First verify that the file exists
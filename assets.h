@@ -42,6 +42,8 @@
 
 // Helper functions
 SDL_Surface* load_asset_image(const char* path);
+SDL_Surface* load_asset_image_indexed(const char* path); // Keeps 8-bit palettes, NULL if missing
+int load_asset_palette(const char* path, SDL_Color* colors, int max_colors); // JASC-PAL, returns color count
 TTF_Font* load_asset_font(const char* path, int size);
 Mix_Music* load_asset_music(const char* path);
 Mix_Chunk* load_asset_sound(const char* path);
@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <string.h>
+#include <SDL/SDL.h>
+#include <SDL/SDL_image.h>
+#include "atlas.h"
+
+// Decoded pages and lookup table, shared by every load_asset_image() call
+static SDL_Surface *atlas_pages[ATLAS_MAX_PAGES];
+static int atlas_page_count = 0;
+static AtlasEntry atlas_entries[ATLAS_MAX_ENTRIES];
+static int atlas_entry_count = 0;
+
+int init_atlas() {
+    FILE *index = fopen(ATLAS_PATH ATLAS_INDEX_FILE, "r");
+    if (index == NULL) {
+        printf("No texture atlas found, images will be loaded separately (run 'make atlas')\n");
+        return 0;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), index)) {
+        if (strncmp(line, "page ", 5) == 0) {
+            int page;
+            char file[64];
+            if (sscanf(line + 5, "%d %63s", &page, file) != 2 || page != atlas_page_count ||
+                atlas_page_count >= ATLAS_MAX_PAGES) {
+                continue;
+            }
+
+            // Decode the page once and convert it to the display format
+            char path[128];
+            snprintf(path, sizeof(path), "%s%s", ATLAS_PATH, file);
+            SDL_Surface *loaded = IMG_Load(path);
+            if (!loaded) {
+                printf("Unable to load atlas page %s: %s\n", path, IMG_GetError());
+                break;
+            }
+            atlas_pages[atlas_page_count] = SDL_DisplayFormatAlpha(loaded);
+            if (atlas_pages[atlas_page_count]) {
+                SDL_FreeSurface(loaded);
+            } else {
+                atlas_pages[atlas_page_count] = loaded;
+            }
+            atlas_page_count++;
+        } else if (strncmp(line, "sprite ", 7) == 0 && atlas_entry_count < ATLAS_MAX_ENTRIES) {
+            AtlasEntry *entry = &atlas_entries[atlas_entry_count];
+            int x, y, w, h;
+            if (sscanf(line + 7, "%95s %d %d %d %d %d", entry->path, &entry->page, &x, &y, &w, &h) != 6) {
+                continue;
+            }
+            entry->rect.x = x;
+            entry->rect.y = y;
+            entry->rect.w = w;
+            entry->rect.h = h;
+            atlas_entry_count++;
+        }
+    }
+    fclose(index);
+
+    // Drop entries pointing outside the pages we managed to load
+    int kept = 0;
+    for (int i = 0; i < atlas_entry_count; i++) {
+        AtlasEntry *entry = &atlas_entries[i];
+        if (entry->page < 0 || entry->page >= atlas_page_count) continue;
+
+        SDL_Surface *page = atlas_pages[entry->page];
+        if (entry->rect.x + entry->rect.w > page->w || entry->rect.y + entry->rect.h > page->h) continue;
+
+        atlas_entries[kept++] = *entry;
+    }
+    atlas_entry_count = kept;
+
+    printf("Texture atlas: %d images in %d pages\n", atlas_entry_count, atlas_page_count);
+    return atlas_entry_count > 0;
+}
+
+SDL_Surface* atlas_lookup(const char *path) {
+    for (int i = 0; i < atlas_entry_count; i++) {
+        AtlasEntry *entry = &atlas_entries[i];
+        if (strcmp(entry->path, path) != 0) continue;
+
+        // View into the page: same pixels, own width/height/pitch
+        SDL_Surface *page = atlas_pages[entry->page];
+        SDL_PixelFormat *fmt = page->format;
+        Uint8 *pixels = (Uint8 *)page->pixels + entry->rect.y * page->pitch + entry->rect.x * fmt->BytesPerPixel;
+
+        SDL_Surface *view = SDL_CreateRGBSurfaceFrom(pixels, entry->rect.w, entry->rect.h, fmt->BitsPerPixel,
+                                                     page->pitch, fmt->Rmask, fmt->Gmask, fmt->Bmask, fmt->Amask);
+        if (view && fmt->Amask) {
+            SDL_SetAlpha(view, SDL_SRCALPHA, SDL_ALPHA_OPAQUE); // Same blending as SDL_DisplayFormatAlpha
+        }
+        return view;
+    }
+    return NULL;
+}
+
+void free_atlas() {
+    for (int i = 0; i < atlas_page_count; i++) {
+        SDL_FreeSurface(atlas_pages[i]);
+        atlas_pages[i] = NULL;
+    }
+    atlas_page_count = 0;
+    atlas_entry_count = 0;
+}
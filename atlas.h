@@ -0,0 +1,29 @@
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include <SDL/SDL.h>
+
+// Atlas pages and lookup table generated by tools/atlaspack ("make atlas")
+#define ATLAS_PATH "assets/atlas/"
+#define ATLAS_INDEX_FILE "atlas.txt"
+#define ATLAS_MAX_PAGES 4
+#define ATLAS_MAX_ENTRIES 64
+
+// Where one packed image lives inside the atlas
+typedef struct {
+    char path[96];                // Original asset path (e.g. PLAYER_SPRITE_PATH)
+    int page;                     // Atlas page index
+    SDL_Rect rect;                // Sub-rect inside the page
+} AtlasEntry;
+
+// Load the lookup table and decode every page once (call after SDL_SetVideoMode)
+int init_atlas();
+
+// Surface viewing the atlas sub-rect for path, or NULL if path is not packed.
+// The view shares the page pixels and can be freed with SDL_FreeSurface.
+SDL_Surface* atlas_lookup(const char *path);
+
+// Free the pages (after every view has been freed)
+void free_atlas();
+
+#endif // ATLAS_H
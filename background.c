@@ -18,11 +18,8 @@ void initBackground(Background* bg, char* filename, int type) {
         SDL_FillRect(bg->img, NULL, SDL_MapRGB(bg->img->format, 0, 0, 100)); // Dark blue fallback
     }
     
-    // Initialize camera position
-    bg->camera_pos.x = 0;
-    bg->camera_pos.y = 0;
-    bg->camera_pos.w = SCREEN_WIDTH;
-    bg->camera_pos.h = SCREEN_HEIGHT;
+    // Initialize camera position; the view never leaves the image
+    init_camera(&bg->camera_pos, SCREEN_WIDTH, SCREEN_HEIGHT, bg->img->w, bg->img->h);
     
     // Initialize screen position
     bg->pos_screen.x = 0;
@@ -40,18 +37,9 @@ void displayBackground(Background* bg, SDL_Surface* screen) {
         // Fixed background - doesn't scroll
         SDL_BlitSurface(bg->img, NULL, screen, &bg->pos_screen);
     } else {
-        // Mobile background - takes camera position into account
-        if (bg->camera_pos.x + bg->camera_pos.w > bg->img->w) {
-            bg->camera_pos.x = bg->img->w - bg->camera_pos.w;
-        }
-        if (bg->camera_pos.y + bg->camera_pos.h > bg->img->h) {
-            bg->camera_pos.y = bg->img->h - bg->camera_pos.h;
-        }
-        if (bg->camera_pos.x < 0) bg->camera_pos.x = 0;
-        if (bg->camera_pos.y < 0) bg->camera_pos.y = 0;
-        
-        // Blit visible portion based on camera position
-        SDL_BlitSurface(bg->img, &bg->camera_pos, screen, &bg->pos_screen);
+        // Mobile background - blit the visible part; the camera was clamped when it moved
+        SDL_Rect view = {bg->camera_pos.x, bg->camera_pos.y, bg->camera_pos.w, bg->camera_pos.h};
+        SDL_BlitSurface(bg->img, &view, screen, &bg->pos_screen);
     }
 }
 
@@ -62,53 +50,32 @@ void scrollBackground(Background* bg, int direction, int speed) {
         return;
     }
     
-    // Adjust camera position based on direction
+    // Adjust camera position based on direction (camera_move keeps it inside the image)
     switch (direction) {
         case 0: // Up
-            bg->camera_pos.y -= speed;
+            camera_move(&bg->camera_pos, 0, -speed);
             break;
             
         case 1: // Down
-            bg->camera_pos.y += speed;
+            camera_move(&bg->camera_pos, 0, speed);
             break;
             
         case 2: // Left
-            bg->camera_pos.x -= speed;
+            camera_move(&bg->camera_pos, -speed, 0);
             break;
             
         case 3: // Right
-            bg->camera_pos.x += speed;
+            camera_move(&bg->camera_pos, speed, 0);
             break;
     }
-    
-    // Ensure camera stays within background bounds
-    if (bg->camera_pos.x < 0) bg->camera_pos.x = 0;
-    if (bg->camera_pos.y < 0) bg->camera_pos.y = 0;
-    if (bg->camera_pos.x + bg->camera_pos.w > bg->img->w) {
-        bg->camera_pos.x = bg->img->w - bg->camera_pos.w;
-    }
-    if (bg->camera_pos.y + bg->camera_pos.h > bg->img->h) {
-        bg->camera_pos.y = bg->img->h - bg->camera_pos.h;
-    }
 }
 
 // Update camera position based on player position
-void updateBackgroundCamera(Background* bg, SDL_Rect playerPos) {
+void updateBackgroundCamera(Background* bg, WorldRect playerPos) {
     if (bg->type == 0) return; // Fixed backgrounds don't update
     
-    // Center camera on player
-    bg->camera_pos.x = playerPos.x - (bg->camera_pos.w / 2) + (playerPos.w / 2);
-    bg->camera_pos.y = playerPos.y - (bg->camera_pos.h / 2) + (playerPos.h / 2);
-    
-    // Ensure camera stays within background bounds
-    if (bg->camera_pos.x < 0) bg->camera_pos.x = 0;
-    if (bg->camera_pos.y < 0) bg->camera_pos.y = 0;
-    if (bg->camera_pos.x + bg->camera_pos.w > bg->img->w) {
-        bg->camera_pos.x = bg->img->w - bg->camera_pos.w;
-    }
-    if (bg->camera_pos.y + bg->camera_pos.h > bg->img->h) {
-        bg->camera_pos.y = bg->img->h - bg->camera_pos.h;
-    }
+    // Center camera on player, clamped to the image
+    camera_follow(&bg->camera_pos, playerPos);
 }
 
 // Initialize game time tracking
@@ -124,6 +91,7 @@ void initGameTime(GameTime* gameTime, char* fontPath, int fontSize) {
     }
     
     gameTime->timeText = NULL; // Will be created on update
+    gameTime->lastElapsed = -1;
     
     // Position time display at top right
     gameTime->timePos.x = SCREEN_WIDTH - 150;
@@ -140,19 +108,23 @@ void updateGameTime(GameTime* gameTime, SDL_Surface* screen) {
     time_t now = time(NULL);
     int elapsed = (int) difftime(now, gameTime->startTime);
     
-    // Format time string
-    int hours = elapsed / 3600;
-    int mins = (elapsed % 3600) / 60;
-    int secs = elapsed % 60;
-    char timeString[20];
-    sprintf(timeString, "%02d:%02d:%02d", hours, mins, secs);
-    
-    // Create text surface
-    SDL_Color white = {255, 255, 255, 255};
-    if (gameTime->timeText) {
-        SDL_FreeSurface(gameTime->timeText);
+    // Re-render the clock only when the displayed second changes
+    if (elapsed != gameTime->lastElapsed || !gameTime->timeText) {
+        // Format time string
+        int hours = elapsed / 3600;
+        int mins = (elapsed % 3600) / 60;
+        int secs = elapsed % 60;
+        char timeString[20];
+        sprintf(timeString, "%02d:%02d:%02d", hours, mins, secs);
+        
+        // Create text surface
+        SDL_Color white = {255, 255, 255, 255};
+        if (gameTime->timeText) {
+            SDL_FreeSurface(gameTime->timeText);
+        }
+        gameTime->timeText = TTF_RenderText_Solid(gameTime->font, timeString, white);
+        gameTime->lastElapsed = elapsed;
     }
-    gameTime->timeText = TTF_RenderText_Solid(gameTime->font, timeString, white);
     
     if (gameTime->timeText) {
         // Display time
@@ -179,6 +151,7 @@ void freeGameTime(GameTime* gameTime) {
         SDL_FreeSurface(gameTime->timeText);
         gameTime->timeText = NULL;
     }
+    gameTime->lastElapsed = -1;
 }
 
 // Split screen for multiplayer or special views
@@ -5,6 +5,7 @@
 #include <SDL/SDL_image.h>
 #include <SDL/SDL_ttf.h>
 #include <time.h>
+#include "camera.h"
 
 /**
  * Structure for background management
@@ -12,7 +13,7 @@
 typedef struct
 {
     SDL_Surface* img;       /* The background image */
-    SDL_Rect camera_pos;    /* Camera position for scrolling */
+    Camera camera_pos;      /* View into the image, in 32-bit world coordinates */
     SDL_Rect pos_screen;    /* Position on screen */
     int type;               /* Type of background: 0-fixed, 1-mobile, 2-destructible */
 } Background;
@@ -26,6 +27,7 @@ typedef struct
     TTF_Font* font;         /* Font for displaying time */
     SDL_Surface* timeText;  /* Surface to render time text */
     SDL_Rect timePos;       /* Position for time display */
+    int lastElapsed;        /* Seconds shown by timeText, -1 if not rendered yet */
 } GameTime;
 
 /**
@@ -60,7 +62,14 @@ void displayBackground(Background* bg, SDL_Surface* screen);
 void scrollBackground(Background* bg, int direction, int speed);
 
 /**
- * Update and display the game time
+ * Center the background's view on the player
+ * @param bg Pointer to the background
+ * @param playerPos Player position in the world
+ */
+void updateBackgroundCamera(Background* bg, WorldRect playerPos);
+
+/**
+ * Update and display the game time (text is only re-rendered when the seconds change)
  * @param gameTime Pointer to the GameTime structure
  * @param screen Screen surface to blit on
  */
@@ -0,0 +1,57 @@
+#include "camera.h"
+
+void init_camera(Camera *camera, int w, int h, int worldW, int worldH) {
+    camera->x = 0;
+    camera->y = 0;
+    camera->w = w;
+    camera->h = h;
+    camera->worldW = worldW;
+    camera->worldH = worldH;
+}
+
+// Keep the view inside the world; a world smaller than the view sticks to its top-left corner
+static void clamper_camera(Camera *camera) {
+    if (camera->worldW > 0 && camera->x > camera->worldW - camera->w) camera->x = camera->worldW - camera->w;
+    if (camera->worldH > 0 && camera->y > camera->worldH - camera->h) camera->y = camera->worldH - camera->h;
+    if (camera->worldW > 0 && camera->x < 0) camera->x = 0;
+    if (camera->worldH > 0 && camera->y < 0) camera->y = 0;
+}
+
+void camera_move(Camera *camera, int dx, int dy) {
+    camera->x += dx;
+    camera->y += dy;
+    clamper_camera(camera);
+}
+
+void camera_follow(Camera *camera, WorldRect target) {
+    camera->x = target.x + target.w / 2 - camera->w / 2;
+    camera->y = target.y + target.h / 2 - camera->h / 2;
+    clamper_camera(camera);
+}
+
+int camera_to_screen(const Camera *camera, WorldRect rect, SDL_Rect *out) {
+    int x = rect.x - camera->x;
+    int y = rect.y - camera->y;
+    if (x >= camera->w || y >= camera->h || x + rect.w <= 0 || y + rect.h <= 0) {
+        return 0;
+    }
+    
+    out->x = (Sint16)x;
+    out->y = (Sint16)y;
+    out->w = (Uint16)rect.w;
+    out->h = (Uint16)rect.h;
+    return 1;
+}
+
+int camera_cull(const Camera *camera, const WorldRect *bounds, int count, int *visible) {
+    int left = camera->x, top = camera->y;
+    int right = camera->x + camera->w, bottom = camera->y + camera->h;
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        const WorldRect *b = &bounds[i];
+        // Branch-free overlap test, the index is always written and only kept if visible
+        visible[n] = i;
+        n += (b->x < right) & (b->y < bottom) & (b->x + b->w > left) & (b->y + b->h > top);
+    }
+    return n;
+}
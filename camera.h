@@ -0,0 +1,37 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <SDL/SDL.h>
+
+// Rectangle in world space. Same layout as SDL_Rect but with 32-bit fields,
+// so levels are not capped at the 32767 px of SDL_Rect's Sint16 coordinates.
+typedef struct {
+    int x;
+    int y;
+    int w;
+    int h;
+} WorldRect;
+
+// Viewport into the world; world coordinates become screen SDL_Rects only at blit time
+typedef struct {
+    int x;                        // World position of the top-left corner of the view
+    int y;
+    int w;                        // View size in pixels
+    int h;
+    int worldW;                   // The view is kept inside [0, worldW) x [0, worldH), 0 = unbounded
+    int worldH;
+} Camera;
+
+void init_camera(Camera *camera, int w, int h, int worldW, int worldH);
+void camera_move(Camera *camera, int dx, int dy);            // Scroll, then clamp to the world
+void camera_follow(Camera *camera, WorldRect target);        // Center on target, then clamp to the world
+
+// Screen position of a world rectangle. Returns 0 (and leaves *out alone) if it is
+// entirely outside the view, so the Sint16 fields of *out never overflow.
+int camera_to_screen(const Camera *camera, WorldRect rect, SDL_Rect *out);
+
+// Batch visibility pass: writes the indices of the bounds that overlap the view
+// to visible[] (in order) and returns how many there are
+int camera_cull(const Camera *camera, const WorldRect *bounds, int count, int *visible);
+
+#endif // CAMERA_H
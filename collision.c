@@ -0,0 +1,678 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL/SDL.h>
+#include "collision.h"
+
+// Squared distances saturate here. Only those under COLLISION_SDF_MAX^2 are kept, so
+// clamping to any larger value leaves the stored field exact.
+#define EDT_CAP ((Sint64)1 << 30)
+
+static int bit_solid(const CollisionMap *map, int x, int y) {
+    return (map->solid[y * map->words + (x >> 6)] >> (x & 63)) & 1;
+}
+
+static int level_bit(const Uint64 *bits, int words, int x, int y) {
+    return (bits[y * words + (x >> 6)] >> (x & 63)) & 1;
+}
+
+// Build each level from the one below (the pixel bitset for level 0)
+static int build_pyramid(CollisionMap *map) {
+    int w = map->w, h = map->h;
+    for (int k = 0; k < COLLISION_PYRAMID_LEVELS && (w > 1 || h > 1); k++) {
+        CollisionLevel *level = &map->levels[k];
+        const Uint64 *belowAny = k == 0 ? map->solid : map->levels[k - 1].any;
+        const Uint64 *belowAll = k == 0 ? map->solid : map->levels[k - 1].all;
+        int belowWords = k == 0 ? map->words : map->levels[k - 1].words;
+
+        level->w = (w + 1) / 2;
+        level->h = (h + 1) / 2;
+        level->words = (level->w + 63) / 64;
+        level->any = calloc(level->words * level->h, sizeof(Uint64));
+        level->all = calloc(level->words * level->h, sizeof(Uint64));
+        map->level_count = k + 1;
+        if (!level->any || !level->all) return 0;
+
+        for (int y = 0; y < level->h; y++) {
+            for (int x = 0; x < level->w; x++) {
+                // Children outside the level below (odd sizes) are ignored
+                int any = 0, all = 1;
+                for (int cy = 2 * y; cy < 2 * y + 2 && cy < h; cy++) {
+                    for (int cx = 2 * x; cx < 2 * x + 2 && cx < w; cx++) {
+                        any |= level_bit(belowAny, belowWords, cx, cy);
+                        all &= level_bit(belowAll, belowWords, cx, cy);
+                    }
+                }
+                if (any) level->any[y * level->words + (x >> 6)] |= (Uint64)1 << (x & 63);
+                if (all) level->all[y * level->words + (x >> 6)] |= (Uint64)1 << (x & 63);
+            }
+        }
+        w = level->w;
+        h = level->h;
+    }
+    return 1;
+}
+
+// Solid pixel in [x0, x1) x [y0, y1) under cell (cx, cy) of level k?
+// Empty and full cells answer without looking further down.
+static int pyramid_any(const CollisionMap *map, int k, int cx, int cy, int x0, int y0, int x1, int y1) {
+    if (k < 0) return bit_solid(map, cx, cy);
+
+    const CollisionLevel *level = &map->levels[k];
+    if (!level_bit(level->any, level->words, cx, cy)) return 0;
+    if (level_bit(level->all, level->words, cx, cy)) return 1;
+
+    int childSize = 1 << k; // Pixel size of a level k - 1 cell
+    int childW = k == 0 ? map->w : map->levels[k - 1].w;
+    int childH = k == 0 ? map->h : map->levels[k - 1].h;
+    for (int y = 2 * cy; y < 2 * cy + 2 && y < childH; y++) {
+        if ((y + 1) * childSize <= y0 || y * childSize >= y1) continue;
+        for (int x = 2 * cx; x < 2 * cx + 2 && x < childW; x++) {
+            if ((x + 1) * childSize <= x0 || x * childSize >= x1) continue;
+            if (pyramid_any(map, k - 1, x, y, x0, y0, x1, y1)) return 1;
+        }
+    }
+    return 0;
+}
+
+// 1D squared distance transform of f (Felzenszwalb & Huttenlocher), linear time.
+// All integer: the parabola intersections are kept as fractions zn / zd (zd > 0) and
+// compared by cross-multiplying, so the result is exact and the same on every build.
+// v, zn and zd are scratch buffers of n entries.
+static void edt_1d(const Sint64 *f, int n, Sint64 *d, int *v, Sint64 *zn, Sint64 *zd) {
+    int k = 0;
+    v[0] = 0;
+
+    // Lower envelope of the parabolas rooted at every sample. Parabola k is the lowest
+    // from its intersection with k - 1 (-infinity for k = 0) to the next one.
+    for (int q = 1; q < n; q++) {
+        Sint64 num, den;
+        for (;;) {
+            num = (f[q] + (Sint64)q * q) - (f[v[k]] + (Sint64)v[k] * v[k]);
+            den = 2 * (Sint64)(q - v[k]);
+            if (k == 0 || num * zd[k] > zn[k] * den) break;
+            k--;
+        }
+        k++;
+        v[k] = q;
+        zn[k] = num;
+        zd[k] = den;
+    }
+
+    int last = k;
+    k = 0;
+    for (int q = 0; q < n; q++) {
+        while (k < last && zn[k + 1] < (Sint64)q * zd[k + 1]) k++;
+        Sint64 dq = (Sint64)(q - v[k]) * (q - v[k]) + f[v[k]];
+        d[q] = dq < EDT_CAP ? dq : EDT_CAP;
+    }
+}
+
+// Exact squared distance (saturated to EDT_CAP) from every pixel to the nearest pixel
+// whose solid bit equals feature
+static int edt_2d(const CollisionMap *map, int feature, Uint32 *out) {
+    int n = map->w > map->h ? map->w : map->h;
+    Sint64 *f = malloc(n * sizeof(Sint64));
+    Sint64 *d = malloc(n * sizeof(Sint64));
+    Sint64 *zn = malloc(n * sizeof(Sint64));
+    Sint64 *zd = malloc(n * sizeof(Sint64));
+    int *v = malloc(n * sizeof(int));
+
+    if (!f || !d || !zn || !zd || !v) {
+        free(f);
+        free(d);
+        free(zn);
+        free(zd);
+        free(v);
+        return 0;
+    }
+
+    // Columns, then rows of the column result
+    for (int x = 0; x < map->w; x++) {
+        for (int y = 0; y < map->h; y++) {
+            f[y] = bit_solid(map, x, y) == feature ? 0 : EDT_CAP;
+        }
+        edt_1d(f, map->h, d, v, zn, zd);
+        for (int y = 0; y < map->h; y++) {
+            out[y * map->w + x] = (Uint32)d[y];
+        }
+    }
+    for (int y = 0; y < map->h; y++) {
+        Uint32 *row = out + y * map->w;
+        for (int x = 0; x < map->w; x++) f[x] = row[x];
+        edt_1d(f, map->w, d, v, zn, zd);
+        for (int x = 0; x < map->w; x++) row[x] = (Uint32)d[x];
+    }
+
+    free(f);
+    free(d);
+    free(zn);
+    free(zd);
+    free(v);
+    return 1;
+}
+
+// Scan the solid runs of every row, 64 pixels at a time over empty or full words.
+// With spans == NULL only counts them.
+static int scan_spans(const CollisionMap *map, CollisionSpan *spans, int *row_start) {
+    int count = 0;
+    for (int y = 0; y < map->h; y++) {
+        const Uint64 *row = map->solid + y * map->words;
+        if (row_start) row_start[y] = count;
+
+        int x = 0;
+        while (x < map->w) {
+            while (x < map->w && !((row[x >> 6] >> (x & 63)) & 1)) {
+                x += ((x & 63) == 0 && row[x >> 6] == 0) ? 64 : 1;
+            }
+            if (x >= map->w) break;
+
+            int start = x;
+            while (x < map->w && ((row[x >> 6] >> (x & 63)) & 1)) {
+                x += ((x & 63) == 0 && row[x >> 6] == ~(Uint64)0) ? 64 : 1;
+            }
+            if (x > map->w) x = map->w;
+
+            if (spans) {
+                spans[count].start = start;
+                spans[count].end = x;
+            }
+            count++;
+        }
+    }
+    if (row_start) row_start[map->h] = count;
+    return count;
+}
+
+// Column spans from the row bitset, read row by row: a run opens where a bit is set and the
+// row above has it clear, and closes on the first clear row. With spans == NULL, counts the
+// runs of column x into col_start[x + 1] and turns the counts into offsets. Otherwise fills
+// spans, using col_start[x] as the write cursor of column x and shifting it back at the end.
+static void scan_column_spans(const CollisionMap *map, CollisionSpan *spans, int *col_start) {
+    for (int y = 0; y <= map->h; y++) {
+        const Uint64 *row = y < map->h ? map->solid + y * map->words : NULL;
+        const Uint64 *prev = y > 0 ? map->solid + (y - 1) * map->words : NULL;
+        for (int i = 0; i < map->words; i++) {
+            Uint64 cur = row ? row[i] : 0, above = prev ? prev[i] : 0;
+            Uint64 opens = cur & ~above, closes = above & ~cur;
+            for (int bit = 0; opens | closes; bit++, opens >>= 1, closes >>= 1) {
+                int x = i * 64 + bit;
+                if (!spans) {
+                    if (opens & 1) col_start[x + 1]++;
+                    continue;
+                }
+                if (opens & 1) spans[col_start[x]].start = y;
+                if (closes & 1) spans[col_start[x]++].end = y;
+            }
+        }
+    }
+
+    if (!spans) {
+        for (int x = 0; x < map->w; x++) col_start[x + 1] += col_start[x];
+    } else {
+        for (int x = map->w; x > 0; x--) col_start[x] = col_start[x - 1];
+        col_start[0] = 0;
+    }
+}
+
+int init_collision_map(CollisionMap *map, SDL_Surface *mask) {
+    memset(map, 0, sizeof(*map));
+    if (mask->w <= 0 || mask->h <= 0) {
+        printf("Empty collision mask\n");
+        return 0;
+    }
+    map->w = mask->w;
+    map->h = mask->h;
+    map->words = (mask->w + 63) / 64;
+    map->solid = calloc(map->words * map->h, sizeof(Uint64));
+    map->sdf = malloc(map->w * map->h);
+
+    Uint32 *toSolid = malloc(map->w * map->h * sizeof(Uint32));
+    Uint32 *toFree = malloc(map->w * map->h * sizeof(Uint32));
+
+    if (!map->solid || !map->sdf || !toSolid || !toFree) {
+        printf("Not enough memory for the collision map\n");
+        free(toSolid);
+        free(toFree);
+        free_collision_map(map);
+        return 0;
+    }
+
+    // Pack the mask: non-black pixels are solid
+    int bpp = mask->format->BytesPerPixel;
+    if (SDL_MUSTLOCK(mask)) SDL_LockSurface(mask);
+    for (int y = 0; y < map->h; y++) {
+        Uint8 *p = (Uint8 *)mask->pixels + y * mask->pitch;
+        Uint64 *row = map->solid + y * map->words;
+        for (int x = 0; x < map->w; x++, p += bpp) {
+            Uint32 pixel = 0;
+            Uint8 r, g, b;
+            memcpy(&pixel, p, bpp);
+            SDL_GetRGB(pixel, mask->format, &r, &g, &b);
+            if (r || g || b) {
+                row[x >> 6] |= (Uint64)1 << (x & 63);
+            }
+        }
+    }
+    if (SDL_MUSTLOCK(mask)) SDL_UnlockSurface(mask);
+
+    // Free pixels store the distance to the closest wall, wall pixels minus the distance to free space
+    int ok = edt_2d(map, 1, toSolid) && edt_2d(map, 0, toFree);
+    if (ok) {
+        for (int i = 0; i < map->w * map->h; i++) {
+            int solid = bit_solid(map, i % map->w, i / map->w);
+            // Round the root of the exact squared distance with integer math
+            Uint32 squared = solid ? toFree[i] : toSolid[i];
+            int value = COLLISION_SDF_MAX;
+            if (squared < COLLISION_SDF_MAX * COLLISION_SDF_MAX) {
+                Uint32 n = squared;
+                Uint32 root = isqrt64(n);
+                value = n - root * root > root ? root + 1 : root;
+            }
+            map->sdf[i] = solid ? -value : value;
+        }
+    }
+    free(toSolid);
+    free(toFree);
+
+    if (!ok) {
+        printf("Not enough memory for the collision distance field\n");
+        free_collision_map(map);
+        return 0;
+    }
+
+    // Row span index: sized for the actual walls, so mostly empty levels cost almost nothing
+    int spanCount = scan_spans(map, NULL, NULL);
+    map->spans = malloc((spanCount > 0 ? spanCount : 1) * sizeof(CollisionSpan));
+    map->row_start = malloc((map->h + 1) * sizeof(int));
+    if (!map->spans || !map->row_start) {
+        printf("Not enough memory for the collision span index\n");
+        free_collision_map(map);
+        return 0;
+    }
+    scan_spans(map, map->spans, map->row_start);
+
+    // Column spans answer the vertical runs of the line of sight
+    map->col_start = calloc(map->w + 1, sizeof(int));
+    if (map->col_start) {
+        scan_column_spans(map, NULL, map->col_start);
+        map->col_spans = malloc((map->col_start[map->w] > 0 ? map->col_start[map->w] : 1) * sizeof(CollisionSpan));
+    }
+    if (!map->col_start || !map->col_spans) {
+        printf("Not enough memory for the collision span index\n");
+        free_collision_map(map);
+        return 0;
+    }
+    scan_column_spans(map, map->col_spans, map->col_start);
+
+    if (!build_pyramid(map)) {
+        printf("Not enough memory for the collision pyramid\n");
+        free_collision_map(map);
+        return 0;
+    }
+    return 1;
+}
+
+void free_collision_map(CollisionMap *map) {
+    free(map->solid);
+    free(map->sdf);
+    free(map->spans);
+    free(map->row_start);
+    free(map->col_spans);
+    free(map->col_start);
+    map->solid = NULL;
+    map->sdf = NULL;
+    map->spans = NULL;
+    map->row_start = NULL;
+    map->col_spans = NULL;
+    map->col_start = NULL;
+    for (int k = 0; k < map->level_count; k++) {
+        free(map->levels[k].any);
+        free(map->levels[k].all);
+        map->levels[k].any = NULL;
+        map->levels[k].all = NULL;
+    }
+    map->level_count = 0;
+    map->w = 0;
+    map->h = 0;
+    map->words = 0;
+}
+
+int collision_solid(const CollisionMap *map, int x, int y) {
+    if (x < 0 || y < 0 || x >= map->w || y >= map->h) return 1;
+    return bit_solid(map, x, y);
+}
+
+// Distance to the nearest wall, the map edges counting as walls
+int collision_clearance(const CollisionMap *map, int x, int y) {
+    if (x < 0 || y < 0 || x >= map->w || y >= map->h) return 0;
+
+    int clearance = map->sdf[y * map->w + x];
+    if (clearance <= 0) return 0;
+    if (x + 1 < clearance) clearance = x + 1;
+    if (y + 1 < clearance) clearance = y + 1;
+    if (map->w - x < clearance) clearance = map->w - x;
+    if (map->h - y < clearance) clearance = map->h - y;
+    return clearance;
+}
+
+int collision_rect(const CollisionMap *map, WorldRect rect) {
+    int x0 = rect.x, y0 = rect.y, x1 = rect.x + rect.w, y1 = rect.y + rect.h;
+    if (rect.w == 0 || rect.h == 0) return 0;
+    if (x0 < 0 || y0 < 0 || x1 > map->w || y1 > map->h) return 1;
+
+    // Free circle around the center covering the whole rect: nothing to scan
+    if (collision_clearance(map, x0 + rect.w / 2, y0 + rect.h / 2) > (rect.w + rect.h) / 2 + 1) return 0;
+
+    // Large areas: walk the pyramid from its top level, empty/full cells end the search early
+    if ((rect.w > 64 || rect.h > 64) && map->level_count > 0) {
+        int top = map->level_count - 1;
+        int size = 2 << top;
+        for (int cy = y0 / size; cy <= (y1 - 1) / size; cy++) {
+            for (int cx = x0 / size; cx <= (x1 - 1) / size; cx++) {
+                if (pyramid_any(map, top, cx, cy, x0, y0, x1, y1)) return 1;
+            }
+        }
+        return 0;
+    }
+
+    // Otherwise test 64 pixels per word
+    int first = x0 >> 6, last = (x1 - 1) >> 6;
+    Uint64 firstMask = ~(Uint64)0 << (x0 & 63);
+    Uint64 lastMask = ~(Uint64)0 >> (63 - ((x1 - 1) & 63));
+    for (int y = y0; y < y1; y++) {
+        const Uint64 *row = map->solid + y * map->words;
+        for (int i = first; i <= last; i++) {
+            Uint64 bits = row[i];
+            if (i == first) bits &= firstMask;
+            if (i == last) bits &= lastMask;
+            if (bits) return 1;
+        }
+    }
+    return 0;
+}
+
+int collision_find_free(const CollisionMap *map, WorldRect *box) {
+    if (!collision_rect(map, *box)) return 1;
+
+    // Finest level whose cells hold the box, so one "any" bit answers per candidate
+    if (map->level_count == 0) return 0;
+    int k = 0, size = 2;
+    while (size < box->w || size < box->h) {
+        if (k + 1 >= map->level_count) return 0;
+        k++;
+        size *= 2;
+    }
+
+    // Rings of cells around the box, closest first
+    const CollisionLevel *level = &map->levels[k];
+    int cx = (box->x + box->w / 2) / size, cy = (box->y + box->h / 2) / size;
+    int maxRing = level->w > level->h ? level->w : level->h;
+    for (int ring = 0; ring <= maxRing; ring++) {
+        for (int y = cy - ring; y <= cy + ring; y++) {
+            for (int x = cx - ring; x <= cx + ring; x++) {
+                if (abs(x - cx) != ring && abs(y - cy) != ring) continue; // Inside: already tested
+                if (x < 0 || y < 0 || x >= level->w || y >= level->h) continue;
+                if ((x + 1) * size > map->w || (y + 1) * size > map->h) continue;
+                if (level_bit(level->any, level->words, x, y)) continue;
+
+                // Empty cell: keep the box as close as possible to where it was asked
+                int bx = box->x, by = box->y;
+                if (bx < x * size) bx = x * size;
+                if (bx > (x + 1) * size - box->w) bx = (x + 1) * size - box->w;
+                if (by < y * size) by = y * size;
+                if (by > (y + 1) * size - box->h) by = (y + 1) * size - box->h;
+                box->x = bx;
+                box->y = by;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// Any solid pixel in rows [a, b] (inclusive) of column x: first span ending after a
+static int column_solid(const CollisionMap *map, int x, int a, int b) {
+    int lo = map->col_start[x], hi = map->col_start[x + 1];
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (map->col_spans[mid].end <= a) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo < map->col_start[x + 1] && map->col_spans[lo].start <= b;
+}
+
+// Any bit set in [a, b] (inclusive) of a bitset line
+static int run_solid(const Uint64 *line, int a, int b) {
+    int first = a >> 6, last = b >> 6;
+    for (int i = first; i <= last; i++) {
+        Uint64 bits = line[i];
+        if (i == first) bits &= ~(Uint64)0 << (a & 63);
+        if (i == last) bits &= ~(Uint64)0 >> (63 - (b & 63));
+        if (bits) return 1;
+    }
+    return 0;
+}
+
+// Every top pyramid cell under the bounding box is empty: nothing can block the line
+static int box_empty_coarse(const CollisionMap *map, int x0, int y0, int x1, int y1) {
+    if (map->level_count == 0) return 0;
+    const CollisionLevel *top = &map->levels[map->level_count - 1];
+    int size = 2 << (map->level_count - 1);
+    for (int cy = y0 / size; cy <= y1 / size; cy++) {
+        for (int cx = x0 / size; cx <= x1 / size; cx++) {
+            if (level_bit(top->any, top->words, cx, cy)) return 0;
+        }
+    }
+    return 1;
+}
+
+int collision_line_of_sight(const CollisionMap *map, int x0, int y0, int x1, int y1) {
+    if (x0 < 0 || y0 < 0 || x0 >= map->w || y0 >= map->h) return 0;
+    if (x1 < 0 || y1 < 0 || x1 >= map->w || y1 >= map->h) return 0;
+
+    if (box_empty_coarse(map, x0 < x1 ? x0 : x1, y0 < y1 ? y0 : y1, x0 > x1 ? x0 : x1, y0 > y1 ? y0 : y1)) {
+        return 1;
+    }
+
+    // Walk along the major axis: the Bresenham line is one run per minor-axis step
+    int horizontal = abs(x1 - x0) >= abs(y1 - y0);
+    int major0 = horizontal ? x0 : y0, major1 = horizontal ? x1 : y1;
+    int minor0 = horizontal ? y0 : x0, minor1 = horizontal ? y1 : x1;
+    int along = abs(major1 - major0), across = abs(minor1 - minor0);
+    int stepMajor = major1 >= major0 ? 1 : -1, stepMinor = minor1 >= minor0 ? 1 : -1;
+
+    for (int r = 0; r <= across; r++) {
+        // Major offsets t whose rounded minor offset is r: 2 * t * across + along >= 2 * r * along
+        int start = 0, end = along;
+        if (across > 0) {
+            if (r > 0) start = ((2 * r - 1) * along + 2 * across - 1) / (2 * across);
+            if (r < across) end = ((2 * r + 1) * along + 2 * across - 1) / (2 * across) - 1;
+        }
+        if (start > end) continue;
+
+        int a = major0 + stepMajor * start, b = major0 + stepMajor * end;
+        if (a > b) {
+            int tmp = a;
+            a = b;
+            b = tmp;
+        }
+        int line = minor0 + stepMinor * r;
+        if (horizontal ? run_solid(map->solid + line * map->words, a, b) : column_solid(map, line, a, b)) return 0;
+    }
+    return 1;
+}
+
+void collision_gradient(const CollisionMap *map, int x, int y, int *gx, int *gy) {
+    *gx = collision_clearance(map, x + 1, y) - collision_clearance(map, x - 1, y);
+    *gy = collision_clearance(map, x, y + 1) - collision_clearance(map, x, y - 1);
+}
+
+int collision_row_first_solid(const CollisionMap *map, int y, int x0, int x1) {
+    if (x0 >= x1) return x1;
+    if (y < 0 || y >= map->h || x0 < 0) return x0; // Outside the map is solid
+
+    if (x0 < map->w) {
+        // First span ending after x0 (spans are disjoint, so ends are sorted too)
+        int lo = map->row_start[y], hi = map->row_start[y + 1];
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (map->spans[mid].end <= x0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo < map->row_start[y + 1] && map->spans[lo].start < x1) {
+            return map->spans[lo].start > x0 ? map->spans[lo].start : x0;
+        }
+    }
+    if (x1 > map->w) return x0 > map->w ? x0 : map->w;
+    return x1;
+}
+
+// Last solid x in [x0, x1), or x0 - 1 if there is none
+static int row_last_solid(const CollisionMap *map, int y, int x0, int x1) {
+    if (x0 >= x1) return x0 - 1;
+    if (y < 0 || y >= map->h || x1 > map->w) return x1 - 1; // Outside the map is solid
+
+    if (x1 > 0) {
+        // Last span starting before x1
+        int lo = map->row_start[y], hi = map->row_start[y + 1];
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (map->spans[mid].start < x1) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo > map->row_start[y] && map->spans[lo - 1].end > x0) {
+            return (map->spans[lo - 1].end < x1 ? map->spans[lo - 1].end : x1) - 1;
+        }
+    }
+    if (x0 < 0) return (x1 < 0 ? x1 : 0) - 1;
+    return x0 - 1;
+}
+
+int collision_first_solid_row(const CollisionMap *map, int x0, int x1, int yFrom, int yTo, int *row) {
+    int step = yTo >= yFrom ? 1 : -1;
+    for (int y = yFrom; y != yTo + step; y += step) {
+        if (collision_row_first_solid(map, y, x0, x1) < x1) {
+            *row = y;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int collision_sweep_x(const CollisionMap *map, WorldRect box, int dx) {
+    int allowed = dx;
+    for (int y = box.y; y < box.y + box.h && allowed != 0; y++) {
+        if (allowed > 0) {
+            // Closest wall in front of the right edge
+            int edge = box.x + box.w;
+            allowed = collision_row_first_solid(map, y, edge, edge + allowed) - edge;
+        } else {
+            // Closest wall before the left edge
+            allowed = row_last_solid(map, y, box.x + allowed, box.x) + 1 - box.x;
+        }
+    }
+    return allowed;
+}
+
+// Sphere tracing: each step advances by the free distance, so thin walls cannot be skipped.
+// Integer only, like the rest of the simulation.
+int collision_sphere_cast(const CollisionMap *map, int x, int y, int dx, int dy, int radius, int *outX, int *outY) {
+    *outX = x;
+    *outY = y;
+
+    int len = (int)isqrt64((Uint64)((Sint64)dx * dx + (Sint64)dy * dy));
+    int clear = collision_clearance(map, x, y);
+    int t = 0;
+    while (t < len) {
+        int room = clear - radius;
+        t += room > 1 ? room : 1;
+        if (t > len) t = len;
+
+        // A step is blocked if it gets closer than radius to a wall. A circle already in
+        // contact (e.g. a box flush against a wall) can still move away or along the wall.
+        int px = x + div_round(dx * t, len);
+        int py = y + div_round(dy * t, len);
+        int next = collision_clearance(map, px, py);
+        if (next <= radius && (next < clear || next <= 0)) return 1;
+        *outX = px;
+        *outY = py;
+        clear = next;
+    }
+    return 0;
+}
+
+int collision_sweep_aabb(const CollisionMap *map, WorldRect box, int dx, int dy, CollisionHit *hit) {
+    int steps = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
+
+    hit->toi = FIX_ONE;
+    hit->x = box.x + dx;
+    hit->y = box.y + dy;
+    hit->normal_x = 0;
+    hit->normal_y = 0;
+    if (steps == 0 || collision_rect(map, box)) return 0;
+
+    // Horizontal and vertical moves: one span lookup per row of the box / per row crossed
+    if (dy == 0) {
+        int allowed = collision_sweep_x(map, box, dx);
+        if (allowed == dx) return 0;
+        hit->toi = fix_div(INT_TO_FIX(allowed), INT_TO_FIX(dx));
+        hit->x = box.x + allowed;
+        hit->normal_x = dx > 0 ? -1 : 1;
+        return 1;
+    }
+    if (dx == 0) {
+        int step = dy > 0 ? 1 : -1;
+        int edge = dy > 0 ? box.y + box.h : box.y - 1; // First row the box enters
+        int row;
+        if (!collision_first_solid_row(map, box.x, box.x + box.w, edge, edge + dy - step, &row)) return 0;
+        hit->toi = fix_div(INT_TO_FIX(row - edge), INT_TO_FIX(dy));
+        hit->y = box.y + row - edge;
+        hit->normal_y = -step;
+        return 1;
+    }
+
+    // The box is free at every step before, so only the column and row it enters can be solid
+    int prevX = box.x, prevY = box.y;
+    for (int i = 1; i <= steps; i++) {
+        int nextX = box.x + dx * i / steps;
+        int nextY = box.y + dy * i / steps;
+        int hitX = 0, hitY = 0;
+
+        if (nextX != prevX) {
+            // Rows of the new position, minus the row entered on a diagonal step:
+            // its corner pixel is tested by the row strip below
+            WorldRect column = {nextX > prevX ? prevX + box.w : nextX, nextY, 1, box.h};
+            if (nextY != prevY) {
+                column.h--;
+                if (nextY < prevY) column.y++;
+            }
+            hitX = column.h > 0 && collision_rect(map, column);
+        }
+        if (nextY != prevY) {
+            WorldRect row = {nextX, nextY > prevY ? prevY + box.h : nextY, box.w, 1};
+            hitY = collision_rect(map, row);
+        }
+
+        if (hitX || hitY) {
+            hit->toi = fix_div(INT_TO_FIX(i - 1), INT_TO_FIX(steps));
+            hit->x = prevX;
+            hit->y = prevY;
+            hit->normal_x = hitX ? (dx > 0 ? -1 : 1) : 0;
+            hit->normal_y = hitY ? (dy > 0 ? -1 : 1) : 0;
+            return 1;
+        }
+        prevX = nextX;
+        prevY = nextY;
+    }
+    return 0;
+}
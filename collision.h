@@ -0,0 +1,83 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include <SDL/SDL.h>
+#include "fixedpoint.h"
+#include "camera.h"
+
+// Distances are stored in pixels, saturated to fit a Sint8
+#define COLLISION_SDF_MAX 127
+
+// Run of solid pixels [start, end) on one row (or column)
+typedef struct {
+    int start;
+    int end;
+} CollisionSpan;
+
+// Coarse levels of the occupancy pyramid: level k has one cell per (2 << k) x (2 << k) pixels
+#define COLLISION_PYRAMID_LEVELS 8
+
+// One pyramid level: per cell, "some pixel is solid" and "every pixel is solid" bits
+typedef struct {
+    int w;                        // Size in cells
+    int h;
+    int words;                    // Uint64 words per row of each bitset
+    Uint64 *any;
+    Uint64 *all;
+} CollisionLevel;
+
+// Collision geometry built once from a collision mask (non-black pixels are solid)
+typedef struct {
+    int w;
+    int h;
+    int words;                    // Uint64 words per row of the bitset
+    Uint64 *solid;                // 1 bit per pixel, bit (x & 63) of word (x >> 6)
+    Sint8 *sdf;                   // Signed distance to the nearest wall: > 0 free, < 0 inside a wall
+    CollisionSpan *spans;         // Solid runs of every row, sorted by x
+    int *row_start;               // Spans of row y are spans[row_start[y]] .. spans[row_start[y + 1] - 1]
+    CollisionSpan *col_spans;     // Solid runs of every column, sorted by y
+    int *col_start;               // Spans of column x are col_spans[col_start[x]] .. col_spans[col_start[x + 1] - 1]
+    CollisionLevel levels[COLLISION_PYRAMID_LEVELS];
+    int level_count;
+} CollisionMap;
+
+// First contact of a box swept along a move
+typedef struct {
+    fixed toi;                    // Fraction of the move done before contact (FIX_ONE if no contact)
+    int x;                        // Box position at contact (or at the end of the move)
+    int y;
+    int normal_x;                 // Contact normal per axis (-1, 0 or 1), pointing out of the wall
+    int normal_y;
+} CollisionHit;
+
+// Build / free
+int init_collision_map(CollisionMap *map, SDL_Surface *mask); // Returns 0 if out of memory
+void free_collision_map(CollisionMap *map);
+
+// Point and area queries (everything outside the map is solid)
+int collision_solid(const CollisionMap *map, int x, int y);
+int collision_clearance(const CollisionMap *map, int x, int y); // Free radius around (x, y), O(1)
+int collision_rect(const CollisionMap *map, WorldRect rect);    // 1 if any solid pixel in rect
+int collision_find_free(const CollisionMap *map, WorldRect *box); // Move box to the closest empty pyramid cell it fits in, 0 if none
+void collision_gradient(const CollisionMap *map, int x, int y, int *gx, int *gy); // Points away from walls
+
+// Span lookups (binary search in the row's solid runs)
+int collision_row_first_solid(const CollisionMap *map, int y, int x0, int x1); // First solid x in [x0, x1), or x1 if none
+int collision_first_solid_row(const CollisionMap *map, int x0, int x1, int yFrom, int yTo, int *row); // Returns 1 and the first row from yFrom to yTo (included) with a solid pixel in [x0, x1)
+int collision_sweep_x(const CollisionMap *map, WorldRect box, int dx); // Part of dx the box can move before touching a wall
+
+// 1 if no solid pixel lies on the line between the two points. The line is walked
+// as horizontal runs tested 64 pixels per word, or vertical runs looked up in the column spans.
+int collision_line_of_sight(const CollisionMap *map, int x0, int y0, int x1, int y1);
+
+// Move a circle of the given radius from (x, y) by (dx, dy) until it touches a wall.
+// Returns 1 on contact; (*outX, *outY) is the last free center. Only steps that bring
+// the circle closer to a wall can be blocked, so one in contact can still move away.
+int collision_sphere_cast(const CollisionMap *map, int x, int y, int dx, int dy, int radius, int *outX, int *outY);
+
+// Sweep box by (dx, dy) along the move: span lookups for horizontal and vertical moves,
+// otherwise pixel by pixel, testing only the pixels the box enters.
+// Returns 1 on contact. A box that starts inside a wall is let through so it can get out.
+int collision_sweep_aabb(const CollisionMap *map, WorldRect box, int dx, int dy, CollisionHit *hit);
+
+#endif // COLLISION_H
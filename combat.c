@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "combat.h"
+#include "particles.h"
+
+int init_combat(Combat *combat, int worldW, int worldH) {
+    combat->enemies = NULL;
+    combat->lastAttack = NULL;
+    combat->pendingDamage = NULL;
+    combat->cellItems = NULL;
+    combat->enemyCount = 0;
+    combat->enemyCapacity = 0;
+    combat->hitCount = 0;
+    combat->nextAttack = 1;
+    
+    combat->gridW = (worldW + COMBAT_GRID_CELL - 1) / COMBAT_GRID_CELL;
+    combat->gridH = (worldH + COMBAT_GRID_CELL - 1) / COMBAT_GRID_CELL;
+    if (combat->gridW < 1) combat->gridW = 1;
+    if (combat->gridH < 1) combat->gridH = 1;
+    combat->cellStart = malloc((combat->gridW * combat->gridH + 1) * sizeof(int));
+    
+    if (!combat->cellStart || !init_pool(&combat->hitboxes, sizeof(Hitbox), COMBAT_MAX_HITBOXES)) {
+        printf("Out of memory for the combat system\n");
+        free(combat->cellStart);
+        combat->cellStart = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+void free_combat(Combat *combat) {
+    free_pool(&combat->hitboxes);
+    free(combat->enemies);
+    free(combat->lastAttack);
+    free(combat->pendingDamage);
+    free(combat->cellStart);
+    free(combat->cellItems);
+    combat->enemies = NULL;
+    combat->lastAttack = NULL;
+    combat->pendingDamage = NULL;
+    combat->cellStart = NULL;
+    combat->cellItems = NULL;
+    combat->enemyCount = 0;
+    combat->enemyCapacity = 0;
+}
+
+int combat_add_enemy(Combat *combat, Enemy *enemy) {
+    if (combat->enemyCount == combat->enemyCapacity) {
+        int capacity = combat->enemyCapacity ? combat->enemyCapacity * 2 : 16;
+        Enemy **enemies = realloc(combat->enemies, capacity * sizeof(Enemy *));
+        if (enemies) combat->enemies = enemies;
+        Uint32 *lastAttack = realloc(combat->lastAttack, capacity * sizeof(Uint32));
+        if (lastAttack) combat->lastAttack = lastAttack;
+        int *pendingDamage = realloc(combat->pendingDamage, capacity * sizeof(int));
+        if (pendingDamage) combat->pendingDamage = pendingDamage;
+        int *cellItems = realloc(combat->cellItems, capacity * sizeof(int));
+        if (cellItems) combat->cellItems = cellItems;
+        if (!enemies || !lastAttack || !pendingDamage || !cellItems) {
+            printf("Out of memory for the combat system\n");
+            return 0;
+        }
+        combat->enemyCapacity = capacity;
+    }
+    
+    int i = combat->enemyCount++;
+    combat->enemies[i] = enemy;
+    combat->lastAttack[i] = 0;
+    combat->pendingDamage[i] = 0;
+    return 1;
+}
+
+Uint32 combat_new_attack(Combat *combat) {
+    Uint32 attack = combat->nextAttack++;
+    if (combat->nextAttack == 0) combat->nextAttack = 1; // 0 means "never hit"
+    return attack;
+}
+
+PoolHandle combat_spawn_hitbox(Combat *combat, WorldRect box, int damage, Uint32 attack, int ticks) {
+    PoolHandle handle;
+    Hitbox *hitbox = pool_alloc(&combat->hitboxes, &handle);
+    if (!hitbox) return POOL_NO_HANDLE;
+    
+    hitbox->box = box;
+    hitbox->damage = damage;
+    hitbox->attack = attack;
+    hitbox->ticks = ticks;
+    return handle;
+}
+
+Hitbox *combat_hitbox(Combat *combat, PoolHandle handle) {
+    return pool_get(&combat->hitboxes, handle);
+}
+
+void combat_remove_hitbox(Combat *combat, PoolHandle handle) {
+    pool_release(&combat->hitboxes, handle);
+}
+
+// Grid cell range covered by a box, clamped to the grid
+static void cellules_boite(const Combat *combat, WorldRect box, int *x0, int *y0, int *x1, int *y1) {
+    *x0 = box.x / COMBAT_GRID_CELL;
+    *y0 = box.y / COMBAT_GRID_CELL;
+    *x1 = (box.x + box.w - 1) / COMBAT_GRID_CELL;
+    *y1 = (box.y + box.h - 1) / COMBAT_GRID_CELL;
+    if (*x0 < 0) *x0 = 0;
+    if (*y0 < 0) *y0 = 0;
+    if (*x1 >= combat->gridW) *x1 = combat->gridW - 1;
+    if (*y1 >= combat->gridH) *y1 = combat->gridH - 1;
+}
+
+// Cell of an enemy's center (counting sort, O(enemies))
+static int cellule_ennemi(const Combat *combat, const Enemy *enemy) {
+    int x0, y0, x1, y1;
+    WorldRect center = {enemy->position.x + enemy->position.w / 2, enemy->position.y + enemy->position.h / 2, 1, 1};
+    cellules_boite(combat, center, &x0, &y0, &x1, &y1);
+    return y0 * combat->gridW + x0;
+}
+
+static void construire_grille(Combat *combat) {
+    int cells = combat->gridW * combat->gridH;
+    for (int c = 0; c <= cells; c++) combat->cellStart[c] = 0;
+    
+    // Count per cell, then running totals: cellStart[c] is the end of cell c
+    for (int i = 0; i < combat->enemyCount; i++) {
+        if (combat->enemies[i]->state == NEUTRALIZED) continue;
+        combat->cellStart[cellule_ennemi(combat, combat->enemies[i])]++;
+    }
+    for (int c = 1; c < cells; c++) combat->cellStart[c] += combat->cellStart[c - 1];
+    combat->cellStart[cells] = combat->cellStart[cells - 1];
+    
+    // Fill each cell from its end; cellStart[c] ends up at the start of cell c
+    for (int i = combat->enemyCount - 1; i >= 0; i--) {
+        if (combat->enemies[i]->state == NEUTRALIZED) continue;
+        combat->cellItems[--combat->cellStart[cellule_ennemi(combat, combat->enemies[i])]] = i;
+    }
+}
+
+static int boites_chevauchent(WorldRect a, WorldRect b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+// Age the hitboxes, removing those whose time is up (backwards: the last one moves into the hole)
+static void vieillir_hitboxes(Combat *combat) {
+    Hitbox *hitboxes = POOL_ITEMS(&combat->hitboxes, Hitbox);
+    for (int h = combat->hitboxes.count - 1; h >= 0; h--) {
+        if (--hitboxes[h].ticks <= 0) pool_release_at(&combat->hitboxes, h);
+    }
+}
+
+void combat_update(Combat *combat) {
+    const Pool *pool = &combat->hitboxes;
+    if (pool->count == 0) return;
+    if (combat->enemyCount == 0) {
+        vieillir_hitboxes(combat);
+        return;
+    }
+    
+    construire_grille(combat);
+    
+    // Enemies are bucketed by their center: widen the search by half a cell, enough
+    // for enemies up to COMBAT_GRID_CELL pixels wide
+    combat->hitCount = 0;
+    const Hitbox *hitboxes = POOL_ITEMS(pool, Hitbox);
+    for (int h = 0; h < pool->count; h++) {
+        WorldRect search = hitboxes[h].box;
+        search.x -= COMBAT_GRID_CELL / 2;
+        search.y -= COMBAT_GRID_CELL / 2;
+        search.w += COMBAT_GRID_CELL;
+        search.h += COMBAT_GRID_CELL;
+        
+        int x0, y0, x1, y1;
+        cellules_boite(combat, search, &x0, &y0, &x1, &y1);
+        for (int cy = y0; cy <= y1; cy++) {
+            for (int cx = x0; cx <= x1; cx++) {
+                int c = cy * combat->gridW + cx;
+                for (int k = combat->cellStart[c]; k < combat->cellStart[c + 1]; k++) {
+                    int e = combat->cellItems[k];
+                    if (combat->lastAttack[e] == hitboxes[h].attack) continue; // Already hit by this attack
+                    if (!boites_chevauchent(hitboxes[h].box, combat->enemies[e]->position)) continue;
+                    if (combat->hitCount == COMBAT_MAX_HITS) continue;
+                    
+                    combat->lastAttack[e] = hitboxes[h].attack;
+                    combat->hits[combat->hitCount].target = e;
+                    combat->hits[combat->hitCount].damage = hitboxes[h].damage;
+                    combat->hitCount++;
+                }
+            }
+        }
+    }
+    
+    // Apply the batch: sum per target, then one damageEnemy (and state update) per target
+    for (int i = 0; i < combat->hitCount; i++) {
+        combat->pendingDamage[combat->hits[i].target] += combat->hits[i].damage;
+    }
+    for (int i = 0; i < combat->hitCount; i++) {
+        int e = combat->hits[i].target;
+        if (combat->pendingDamage[e] > 0) {
+            WorldRect target = combat->enemies[e]->position;
+            emit_particles(target.x + target.w / 2, target.y + target.h / 2, COMBAT_SPARK_PARTICLES, 250, PARTICLE_SPARK, 300);
+            damageEnemy(combat->enemies[e], combat->pendingDamage[e]);
+            combat->pendingDamage[e] = 0;
+        }
+    }
+    
+    vieillir_hitboxes(combat);
+}
@@ -0,0 +1,61 @@
+#ifndef COMBAT_H
+#define COMBAT_H
+
+#include <SDL/SDL.h>
+#include "camera.h"
+#include "pool.h"
+#include "ennemie.h"
+
+#define COMBAT_MAX_HITBOXES 64
+#define COMBAT_MAX_HITS 256       // Hits collected per tick
+#define COMBAT_GRID_CELL 128      // Broadphase cell size in pixels
+#define COMBAT_SPARK_PARTICLES 24 // Sparks per enemy hit
+
+// Damage area that lives in the world for a number of ticks
+typedef struct {
+    WorldRect box;
+    int damage;
+    Uint32 attack;                // A target is hit at most once per attack
+    int ticks;                    // Removed by combat_update after this many ticks (owners refresh it)
+} Hitbox;
+
+// One hitbox overlapping one enemy this tick
+typedef struct {
+    int target;                   // Index of the enemy in the combat system
+    int damage;
+} CombatHit;
+
+typedef struct {
+    Pool hitboxes;                // Hitbox objects
+    
+    Enemy **enemies;              // Enemies that can be hit
+    Uint32 *lastAttack;           // Per enemy: last attack that hit it
+    int *pendingDamage;           // Per enemy: damage summed over this tick's hits
+    int enemyCount;
+    int enemyCapacity;
+    
+    // Broadphase: enemy indices sorted by grid cell, rebuilt each tick hitboxes exist
+    int gridW;
+    int gridH;
+    int *cellStart;               // Enemies of cell c are cellItems[cellStart[c] .. cellStart[c + 1] - 1]
+    int *cellItems;
+    
+    CombatHit hits[COMBAT_MAX_HITS];
+    int hitCount;
+    Uint32 nextAttack;
+} Combat;
+
+int init_combat(Combat *combat, int worldW, int worldH); // Returns 0 if out of memory
+void free_combat(Combat *combat);
+int combat_add_enemy(Combat *combat, Enemy *enemy);     // Returns 0 if out of memory
+
+Uint32 combat_new_attack(Combat *combat);
+PoolHandle combat_spawn_hitbox(Combat *combat, WorldRect box, int damage, Uint32 attack, int ticks); // POOL_NO_HANDLE if full
+Hitbox *combat_hitbox(Combat *combat, PoolHandle handle); // NULL once removed
+void combat_remove_hitbox(Combat *combat, PoolHandle handle);
+
+// Collect the hits of every hitbox through the broadphase, then apply them:
+// each enemy takes the sum of its hits once (damageEnemy). Expired hitboxes are removed.
+void combat_update(Combat *combat);
+
+#endif // COMBAT_H
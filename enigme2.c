@@ -5,6 +5,51 @@
 #define MIN_ZOOM 1.0
 #define ZOOM_STEP 0.05
 #define ANIMATION_DURATION 2000 // 2 seconds
+#define ZOOM_DURATION 500       // ms to zoom from MIN_ZOOM to MAX_ZOOM (and back)
+#define ZOOM_CYCLES 3           // Zoom cycles before the animation ends
+#define END_PAUSE 1000          // ms the result stays on screen before leaving
+#define SUCCESS_PARTICLES 400   // Burst on the placed piece when the puzzle is solved
+
+// Success/failure message animation: zoom in and out ZOOM_CYCLES times
+static int sequence_zoom(Sequence *seq) {
+    Enigme2 *e = seq->data;
+    SEQ_BEGIN(seq);
+    for (e->zoom_cycles = 0; e->zoom_cycles < ZOOM_CYCLES; e->zoom_cycles++) {
+        SEQ_TWEEN(seq, ZOOM_DURATION) {
+            e->zoom_factor = MIN_ZOOM + (MAX_ZOOM - MIN_ZOOM) * sequence_progress(seq) / FIX_ONE;
+            SEQ_YIELD(seq);
+        }
+        SEQ_TWEEN(seq, ZOOM_DURATION) {
+            e->zoom_factor = MAX_ZOOM - (MAX_ZOOM - MIN_ZOOM) * sequence_progress(seq) / FIX_ONE;
+            SEQ_YIELD(seq);
+        }
+    }
+    e->animation_active = 0;
+    SEQ_END(seq);
+}
+
+// Start the success/failure zoom animation
+static void demarrer_animation(Enigme2 *e) {
+    e->animation_active = 1;
+    e->zoom_factor = MIN_ZOOM;
+    start_sequence(&e->zoom_sequence, sequence_zoom, e, SDL_GetTicks());
+}
+
+// Time limit reached
+static void temps_ecoule(void *data) {
+    Enigme2 *e = data;
+    e->time_up = 1;
+    if (!e->solved && !e->animation_active) {
+        demarrer_animation(e);
+    }
+}
+
+// Leave the enigme once the result has been shown for END_PAUSE ms
+static int sequence_fin(Sequence *seq) {
+    SEQ_BEGIN(seq);
+    SEQ_WAIT(seq, END_PAUSE);
+    SEQ_END(seq);
+}
 
 // Initialize enigme2
 void init_enigme2(Enigme2 *e) {
@@ -39,12 +84,16 @@ void init_enigme2(Enigme2 *e) {
     e->started = 0;
     e->solved = 0;
     e->time_limit = 60;  // 60 seconds to solve
-    e->start_time = 0;
-    e->time_remaining = e->time_limit * 1000; // Convert to milliseconds
+    e->time_up = 0;
     
     e->zoom_factor = MIN_ZOOM;
+    e->zoom_cycles = 0;
     e->animation_active = 0;
     
+    // Timers run on wall-clock time while the enigme is played
+    init_timer_wheel(&e->timers, SDL_GetTicks());
+    init_timer(&e->time_timer, temps_ecoule, e);
+    
     // Generate the puzzle
     generate_puzzle(e);
 }
@@ -113,8 +162,11 @@ void generate_puzzle(Enigme2 *e) {
     e->target_piece.position.h = e->target_piece.image->h;
     
     // Reset timer
-    e->start_time = SDL_GetTicks();
-    e->time_remaining = e->time_limit * 1000;
+    timer_advance(&e->timers, SDL_GetTicks());
+    timer_start(&e->timers, &e->time_timer, e->time_limit * 1000, 0);
+    e->time_up = 0;
+    e->last_update = SDL_GetTicks();
+    clear_particles();
     
     e->started = 1;
     e->solved = 0;
@@ -142,9 +194,7 @@ void display_enigme2(Enigme2 *e, SDL_Surface *screen) {
     }
     
     // Draw timer as a progress bar
-    Uint32 elapsed = SDL_GetTicks() - e->start_time;
-    Uint32 remaining = e->time_limit * 1000 - elapsed;
-    if (remaining > e->time_limit * 1000) remaining = 0;  // Handle overflow
+    Uint32 remaining = timer_remaining(&e->timers, &e->time_timer);
     
     int bar_width = 400;
     int bar_height = 20;
@@ -169,8 +219,13 @@ void display_enigme2(Enigme2 *e, SDL_Surface *screen) {
     
     SDL_FillRect(screen, &bar, bar_color);
     
+    // Particles are in screen coordinates here
+    Camera fixed_view;
+    init_camera(&fixed_view, screen->w, screen->h, 0, 0);
+    draw_particles(screen, &fixed_view);
+    
     // Display success/failure message if solved or time's up
-    if (e->solved || remaining <= 0) {
+    if (e->solved || e->time_up) {
         SDL_Surface *message = e->solved ? e->success_message : e->failure_message;
         if (message && e->animation_active) {
             // Apply simple animation effect without using SDL_rotozoom
@@ -201,7 +256,7 @@ void display_enigme2(Enigme2 *e, SDL_Surface *screen) {
 
 // Handle events for enigme2
 int handle_enigme2_events(Enigme2 *e, SDL_Event *event) {
-    if (!e->started || e->animation_active) return 0;
+    if (!e->started || e->animation_active || e->solved || e->time_up) return 0; // No moves once finished
     
     switch (event->type) {
         case SDL_MOUSEBUTTONDOWN:
@@ -247,14 +302,16 @@ int handle_enigme2_events(Enigme2 *e, SDL_Event *event) {
                             // Check if this is the correct piece
                             if (e->pieces[i].is_correct) {
                                 e->solved = 1;
+                                timer_cancel(&e->time_timer); // The clock stops once solved
+                                emit_particles(target.x + target.w / 2, target.y + target.h / 2,
+                                               SUCCESS_PARTICLES, 300, PARTICLE_SUCCESS, 1500);
                             } else {
                                 // Wrong piece, reset its position
                                 e->pieces[i].position = e->pieces[i].original_position;
                             }
                             
                             // Start animation sequence
-                            e->animation_active = 1;
-                            e->zoom_factor = MIN_ZOOM;
+                            demarrer_animation(e);
                         } else {
                             // Reset position if not dropped in target area
                             e->pieces[i].position = e->pieces[i].original_position;
@@ -280,61 +337,24 @@ int handle_enigme2_events(Enigme2 *e, SDL_Event *event) {
             break;
     }
     
-    // Check if time's up
-    Uint32 elapsed = SDL_GetTicks() - e->start_time;
-    if (elapsed >= e->time_limit * 1000 && !e->solved && !e->animation_active) {
-        e->animation_active = 1;
-        e->zoom_factor = MIN_ZOOM;
-    }
-    
     return 0;
 }
 
-// Update enigme2 state (time, animation, etc.)
+// Update enigme2 state (time, animation, etc.): the time limit is a timer, the zoom a sequence
 void update_enigme2(Enigme2 *e) {
-    // Update timer
-    if (e->started && !e->solved && !e->animation_active) {
-        Uint32 elapsed = SDL_GetTicks() - e->start_time;
-        if (elapsed >= e->time_limit * 1000) {
-            e->animation_active = 1;
-        }
-    }
-    
-    // Update animation
+    Uint32 now = SDL_GetTicks();
+    timer_advance(&e->timers, now);
     if (e->animation_active) {
-        static Uint32 last_zoom_time = 0;
-        Uint32 current_time = SDL_GetTicks();
-        
-        if (current_time - last_zoom_time > 50) {  // Update zoom every 50ms
-            last_zoom_time = current_time;
-            
-            // Zoom in until max, then zoom out
-            static int zoom_direction = 1;  // 1 for in, -1 for out
-            
-            e->zoom_factor += ZOOM_STEP * zoom_direction;
-            
-            if (e->zoom_factor >= MAX_ZOOM) {
-                zoom_direction = -1;
-            } else if (e->zoom_factor <= MIN_ZOOM) {
-                zoom_direction = 1;
-                
-                // If we're back to minimum zoom, end animation after a few cycles
-                static int cycles = 0;
-                cycles++;
-                if (cycles >= 3) {  // 3 zoom cycles
-                    e->animation_active = 0;
-                    cycles = 0;
-                    
-                    // Return to main game if puzzle is solved or failed
-                    return;
-                }
-            }
-        }
+        run_sequence(&e->zoom_sequence, now);
     }
+    update_particles(now - e->last_update);
+    e->last_update = now;
 }
 
 // Clean up resources
 void free_enigme2(Enigme2 *e) {
+    timer_cancel(&e->time_timer);
+    
     if (e->puzzle_image) SDL_FreeSurface(e->puzzle_image);
     if (e->background) SDL_FreeSurface(e->background);
     if (e->success_message) SDL_FreeSurface(e->success_message);
@@ -365,6 +385,8 @@ int play_enigme2(SDL_Surface *screen) {
     SDL_Event event;
     int quit = 0;
     int result = 0;  // 0 for failure, 1 for success
+    Sequence ending;  // Pause before leaving, started when the enigme is finished
+    int finished = 0;
     
     while (!quit) {
         // Handle events
@@ -388,18 +410,18 @@ int play_enigme2(SDL_Surface *screen) {
         // Delay to control frame rate
         SDL_Delay(16);  // ~60 FPS
         
-        // Check if enigme is finished
-        if (e.solved && !e.animation_active) {
-            result = 1;  // Success
-            SDL_Delay(1000);  // Wait a second before quitting
-            quit = 1;
-        } else if (SDL_GetTicks() - e.start_time >= e.time_limit * 1000 && !e.animation_active) {
-            result = 0;  // Failure
-            SDL_Delay(1000);  // Wait a second before quitting
+        // Check if enigme is finished, then keep drawing frames for a second before quitting
+        if (!finished && !e.animation_active && (e.solved || e.time_up)) {
+            result = e.solved;  // Success or failure
+            finished = 1;
+            start_sequence(&ending, sequence_fin, NULL, SDL_GetTicks());
+        }
+        if (finished && run_sequence(&ending, SDL_GetTicks()) == SEQ_DONE) {
             quit = 1;
         }
     }
     
     free_enigme2(&e);
+    clear_particles();
     return result;
 }
\ No newline at end of file
@@ -8,6 +8,9 @@
 #include <time.h>
 #include <stdlib.h>
 #include "assets.h"
+#include "timer.h"
+#include "sequence.h"
+#include "particles.h"
 
 // Structure to represent a puzzle piece
 typedef struct {
@@ -33,11 +36,16 @@ typedef struct {
     int started;                       // Flag to indicate if enigme has started
     int solved;                        // Flag to indicate if enigme is solved
     int time_limit;                    // Time limit in seconds
-    Uint32 start_time;                 // Time when enigme started
-    Uint32 time_remaining;             // Remaining time
+    int time_up;                       // Set when time_timer fires
     
     double zoom_factor;                // For rotozoom animation
+    int zoom_cycles;                   // Zoom cycles done by the current animation
     int animation_active;              // Flag for active animation
+    Sequence zoom_sequence;            // Zoom in and out ZOOM_CYCLES times
+    
+    TimerWheel timers;                 // Wall-clock timers of this enigme
+    Timer time_timer;                  // Fires when the time limit is reached
+    Uint32 last_update;                // Ticks of the previous update, for the particles
 } Enigme2;
 
 // Function to initialize enigme2
@@ -2,10 +2,24 @@
 #include <stdlib.h>
 #include <SDL/SDL.h>
 #include <SDL/SDL_image.h>
-#include <math.h>
 #include "ennemie.h"
+#include "particles.h"
 #include "assets.h" // Include for proper asset loading
 
+// Animation names looked up in the sprite sheet metadata, indexed by EnemyState
+static const char *enemy_anim_names[3] = {"alive", "wounded", "neutralized"};
+
+// Timer callbacks
+static void frame_suivante_ennemi(void *data) {
+    Enemy *enemy = data;
+    enemy->frame_current = (enemy->frame_current + 1) % enemy->frame_count;
+}
+
+static void ranger_es(void *data) {
+    Enemy *enemy = data;
+    enemy->es_active = 0;
+}
+
 // Initialize enemy based on level
 void initEnemy(Enemy *enemy, EnemyLevel level, int x, int y) {
     // Initialize basic properties
@@ -19,11 +33,13 @@ void initEnemy(Enemy *enemy, EnemyLevel level, int x, int y) {
     
     enemy->frame_current = 0;
     enemy->frame_count = 4;
-    enemy->frame_delay = 5;
-    enemy->frame_timer = 0;
+    enemy->frame_delay = 100;
+    init_timer(&enemy->frame_timer, frame_suivante_ennemi, enemy);
     
     enemy->current_patrol_point = 0;
     enemy->es_active = 0;
+    init_timer(&enemy->es_timer, ranger_es, enemy);
+    init_hud_bar(&enemy->health_bar);
     
     // Set level-specific properties
     if (level == LEVEL1) {
@@ -59,13 +75,26 @@ void initEnemy(Enemy *enemy, EnemyLevel level, int x, int y) {
         SDL_FillRect(enemy->es_sprite, NULL, SDL_MapRGB(enemy->es_sprite->format, 255, 255, 0)); // Yellow fallback
     }
     
-    // Set up animation rectangles - these would be adjusted based on your sprite sheet
+    // Set up animation frames from the sheet metadata, or a grid of 64x64 cells
+    SpriteSheet sheet;
+    char metaPath[128];
+    spritesheet_meta_path(ENEMY_SPRITE_PATH, metaPath, sizeof(metaPath));
+    if (!load_spritesheet_meta(&sheet, metaPath, enemy->sprite)) {
+        int cols = enemy->sprite->w / 64 > 0 ? enemy->sprite->w / 64 : 1;
+        int rows = enemy->sprite->h / 64 > 0 ? enemy->sprite->h / 64 : 1;
+        spritesheet_from_grid(&sheet, enemy->sprite, cols, rows); // One row per state
+    }
+    enemy->position.w = sheet.cell_w;
+    enemy->position.h = sheet.cell_h;
+    
     for (int state = 0; state < 3; state++) {
-        for (int dir = 0; dir < 4; dir++) {
-            enemy->animation[state][dir].x = dir * 64;
-            enemy->animation[state][dir].y = state * 64;
-            enemy->animation[state][dir].w = 64;
-            enemy->animation[state][dir].h = 64;
+        int anim = spritesheet_find_anim(&sheet, enemy_anim_names[state]);
+        if (anim < 0) anim = state < sheet.anim_count ? state : 0;
+        
+        int count = sheet.anims[anim].count > 0 ? sheet.anims[anim].count : 1;
+        for (int frame = 0; frame < 4; frame++) {
+            enemy->animation[state][frame] = sheet.frames[sheet.anims[anim].frames[frame % count]];
+            build_sprite_mask(&enemy->masks[state][frame], enemy->sprite, &enemy->animation[state][frame]);
         }
     }
     
@@ -82,29 +111,70 @@ void initEnemy(Enemy *enemy, EnemyLevel level, int x, int y) {
     enemy->es_position.h = 32; // ES height
 }
 
+// Move a spawn that overlaps walls to the closest free spot, patrol points and ES included
+void placeEnemy(Enemy *enemy, const CollisionMap *map) {
+    if (map == NULL) return;
+    
+    WorldRect box = enemy->position;
+    if (!collision_find_free(map, &box)) {
+        printf("No free spot for the enemy near (%d, %d)\n", enemy->position.x, enemy->position.y);
+        return;
+    }
+    
+    int dx = box.x - enemy->position.x;
+    int dy = box.y - enemy->position.y;
+    enemy->position = box;
+    for (int i = 0; i < 2; i++) {
+        enemy->patrol_points[i].x += dx;
+        enemy->patrol_points[i].y += dy;
+    }
+    enemy->es_position.x += dx;
+    enemy->es_position.y += dy;
+}
+
 // Display enemy and its ES if active
-void displayEnemy(SDL_Surface *screen, Enemy *enemy) {
+void displayEnemy(RenderQueue *queue, Enemy *enemy, const Camera *camera) {
     // Only display if not neutralized
     if (enemy->state != NEUTRALIZED) {
-        // Determine which part of the sprite sheet to use based on direction and state
-        SDL_Rect src_rect = enemy->animation[enemy->state][enemy->direction];
-        src_rect.x = src_rect.x + (enemy->frame_current * src_rect.w);
+        // World positions become screen rectangles here; off-screen parts are skipped
+        SDL_Rect dest, esDest;
+        int visible = camera_to_screen(camera, enemy->position, &dest);
         
-        // Blit enemy sprite
-        SDL_BlitSurface(enemy->sprite, &src_rect, screen, &enemy->position);
+        // Only the opaque part of the current frame for this state, sorted by the feet
+        if (visible) {
+            render_sprite(queue, LAYER_WORLD, dest.y + enemy->position.h, enemy->sprite,
+                          &enemy->animation[enemy->state][enemy->frame_current], dest.x, dest.y);
+        }
         
         // Display ES if active
-        if (enemy->es_active) {
-            SDL_BlitSurface(enemy->es_sprite, NULL, screen, &enemy->es_position);
+        if (enemy->es_active && camera_to_screen(camera, enemy->es_position, &esDest)) {
+            render_blit(queue, LAYER_WORLD, esDest.y + enemy->es_position.h, enemy->es_sprite, NULL, esDest.x, esDest.y);
         }
         
-        // Draw health bar
-        SDL_Rect health_bg = {enemy->position.x, enemy->position.y - 10, enemy->position.w, 5};
-        SDL_Rect health_fg = {enemy->position.x, enemy->position.y - 10, (enemy->health * enemy->position.w) / enemy->max_health, 5};
-        
-        SDL_FillRect(screen, &health_bg, SDL_MapRGB(screen->format, 255, 0, 0)); // Red bg
-        SDL_FillRect(screen, &health_fg, SDL_MapRGB(screen->format, 0, 255, 0)); // Green fg
+        // Draw health bar (cached surface, rebuilt only when health changes)
+        if (visible) {
+            SDL_Surface *bar = hud_bar_surface(&enemy->health_bar, queue->format, enemy->position.w, 5,
+                                               enemy->health, enemy->max_health);
+            render_blit(queue, LAYER_OVERLAY, 0, bar, NULL, dest.x, dest.y - 10);
+        }
+    }
+}
+
+// Union of the sprite, the health bar above it and the active ES, for view culling
+WorldRect enemyBounds(const Enemy *enemy) {
+    WorldRect b = enemy->position;
+    b.y -= 10; // Health bar
+    b.h += 10;
+    if (enemy->es_active) {
+        const WorldRect *es = &enemy->es_position;
+        int right = b.x + b.w > es->x + es->w ? b.x + b.w : es->x + es->w;
+        int bottom = b.y + b.h > es->y + es->h ? b.y + b.h : es->y + es->h;
+        if (es->x < b.x) b.x = es->x;
+        if (es->y < b.y) b.y = es->y;
+        b.w = right - b.x;
+        b.h = bottom - b.y;
     }
+    return b;
 }
 
 // Free enemy resources
@@ -118,80 +188,102 @@ void freeEnemy(Enemy *enemy) {
         SDL_FreeSurface(enemy->es_sprite);
         enemy->es_sprite = NULL;
     }
+    
+    for (int state = 0; state < 3; state++) {
+        for (int frame = 0; frame < 4; frame++) {
+            free_sprite_mask(&enemy->masks[state][frame]);
+        }
+    }
+    
+    free_hud_bar(&enemy->health_bar);
+    
+    timer_cancel(&enemy->frame_timer);
+    timer_cancel(&enemy->es_timer);
 }
 
-// Animate enemy by cycling through frames
-void animateEnemy(Enemy *enemy) {
-    if (enemy->state != NEUTRALIZED) {
-        enemy->frame_timer++;
-        
-        if (enemy->frame_timer > enemy->frame_delay) {
-            enemy->frame_current = (enemy->frame_current + 1) % enemy->frame_count;
-            enemy->frame_timer = 0;
+// Animate enemy by cycling through frames. The frame timer is one-shot and only
+// re-armed here, so an enemy that is not animated (out of view) costs nothing.
+void animateEnemy(Enemy *enemy, TimerWheel *timers) {
+    if (enemy->state != NEUTRALIZED && !timer_pending(&enemy->frame_timer)) {
+        timer_start(timers, &enemy->frame_timer, enemy->frame_delay, 0);
+    }
+}
+
+// Collision circle of the enemy, centered on its bounding box
+static int rayon_ennemi(const Enemy *enemy) {
+    int size = enemy->position.w < enemy->position.h ? enemy->position.w : enemy->position.h;
+    return size / 2;
+}
+
+// Move the enemy's circle by (dx, dy) against the distance field, sliding along walls
+static void deplacer_ennemi(Enemy *enemy, int dx, int dy, const CollisionMap *map) {
+    if (map == NULL) {
+        // No collision map provided, move freely
+        enemy->position.x += dx;
+        enemy->position.y += dy;
+        return;
+    }
+    
+    int radius = rayon_ennemi(enemy);
+    int cx = enemy->position.x + enemy->position.w / 2;
+    int cy = enemy->position.y + enemy->position.h / 2;
+    int nx, ny;
+    
+    if (collision_sphere_cast(map, cx, cy, dx, dy, radius, &nx, &ny)) {
+        // Blocked: keep only the part of the move tangent to the wall
+        int gx, gy;
+        collision_gradient(map, nx, ny, &gx, &gy);
+        int dot = dx * gx + dy * gy;
+        if (dot < 0) {
+            int norm2 = gx * gx + gy * gy;
+            collision_sphere_cast(map, nx, ny, dx - dot * gx / norm2, dy - dot * gy / norm2, radius, &nx, &ny);
         }
     }
+    
+    enemy->position.x = nx - enemy->position.w / 2;
+    enemy->position.y = ny - enemy->position.h / 2;
 }
 
-// Move enemy randomly between patrol points
-void moveEnemy(Enemy *enemy, SDL_Surface *mask) {
+// Move enemy randomly between patrol points (frames: frames since the last update)
+void moveEnemy(Enemy *enemy, const CollisionMap *map, int frames) {
     if (enemy->state == NEUTRALIZED) {
         return; // Don't move if neutralized
     }
     
+    int step = enemy->move_speed * frames; // Longer steps when updated less often
+    
     // Get target point
-    SDL_Rect target = enemy->patrol_points[enemy->current_patrol_point];
+    WorldRect target = enemy->patrol_points[enemy->current_patrol_point];
     
     // Calculate direction to move
     int dx = 0;
     int dy = 0;
     
     if (enemy->position.x < target.x) {
-        dx = enemy->move_speed;
+        dx = step;
         enemy->direction = ENEMY_RIGHT;
     } else if (enemy->position.x > target.x) {
-        dx = -enemy->move_speed;
+        dx = -step;
         enemy->direction = ENEMY_LEFT;
     }
     
     if (enemy->position.y < target.y) {
-        dy = enemy->move_speed;
+        dy = step;
         enemy->direction = ENEMY_DOWN;
     } else if (enemy->position.y > target.y) {
-        dy = -enemy->move_speed;
+        dy = -step;
         enemy->direction = ENEMY_UP;
     }
     
     // Check if we reached the target point
-    if (abs(enemy->position.x - target.x) < enemy->move_speed &&
-        abs(enemy->position.y - target.y) < enemy->move_speed) {
+    if (abs(enemy->position.x - target.x) < step &&
+        abs(enemy->position.y - target.y) < step) {
         // Switch to next patrol point
         enemy->current_patrol_point = (enemy->current_patrol_point + 1) % 2;
     }
     
     // Apply movement with proper collision check
-    int newX = enemy->position.x + dx;
-    int newY = enemy->position.y + dy;
-    
-    // Only check collision if mask is provided
-    if (mask != NULL) {
-        // Check boundaries first
-        if (newX >= 0 && newX < mask->w && newY >= 0 && newY < mask->h) {
-            Uint32 pixel;
-            int bpp = mask->format->BytesPerPixel;
-            Uint8 *p = (Uint8 *)mask->pixels + newY * mask->pitch + newX * bpp;
-            pixel = *(Uint32 *)p;
-            
-            // If pixel is not black (collision), don't move
-            if (pixel != 0) {
-                enemy->position.x = newX;
-                enemy->position.y = newY;
-            }
-        }
-    } else {
-        // No collision mask provided, move freely
-        enemy->position.x = newX;
-        enemy->position.y = newY;
-    }
+    deplacer_ennemi(enemy, dx, dy, map);
     
     // Update ES position if active
     if (enemy->es_active) {
@@ -200,26 +292,35 @@ void moveEnemy(Enemy *enemy, SDL_Surface *mask) {
     }
 }
 
-// Move enemy with AI towards player
-void moveEnemyAI(Enemy *enemy, SDL_Rect player_pos, SDL_Surface *mask) {
+// Line of sight between the enemy's center and the player's center
+static int canSeePlayer(const Enemy *enemy, WorldRect player_pos, const CollisionMap *map) {
+    if (map == NULL) return 1;
+    return collision_line_of_sight(map,
+                                   enemy->position.x + enemy->position.w / 2, enemy->position.y + enemy->position.h / 2,
+                                   player_pos.x + player_pos.w / 2, player_pos.y + player_pos.h / 2);
+}
+
+// Move enemy with AI towards player (frames: frames since the last update, as for moveEnemy)
+void moveEnemyAI(Enemy *enemy, WorldRect player_pos, const CollisionMap *map, int frames, TimerWheel *timers) {
     if (enemy->state == NEUTRALIZED) {
         return; // Don't move if neutralized
     }
     
-    // Calculate distance to player
+    // Calculate distance to player (integer square root, same result on every machine)
     int dx = player_pos.x - enemy->position.x;
     int dy = player_pos.y - enemy->position.y;
-    float distance = sqrt(dx*dx + dy*dy);
+    int distance = (int)isqrt64((Uint64)((Sint64)dx * dx + (Sint64)dy * dy));
     
-    // If player is within detection range, move toward them
-    if (distance < enemy->detect_range) {
-        // Normalize direction
-        float vx = dx / distance;
-        float vy = dy / distance;
+    // If player is within detection range and not hidden behind a wall, move toward them
+    if (distance < enemy->detect_range && distance > 0 && canSeePlayer(enemy, player_pos, map)) {
+        // Normalize direction (16.16 fixed point)
+        fixed vx = (fixed)((Sint64)dx * FIX_ONE / distance);
+        fixed vy = (fixed)((Sint64)dy * FIX_ONE / distance);
         
         // Move in that direction
-        int moveX = vx * enemy->move_speed;
-        int moveY = vy * enemy->move_speed;
+        int step = enemy->move_speed * frames;
+        int moveX = FIX_ROUND(vx * step);
+        int moveY = FIX_ROUND(vy * step);
         
         // Set direction based on movement
         if (abs(moveX) > abs(moveY)) {
@@ -228,31 +329,24 @@ void moveEnemyAI(Enemy *enemy, SDL_Rect player_pos, SDL_Surface *mask) {
             enemy->direction = (moveY > 0) ? ENEMY_DOWN : ENEMY_UP;
         }
         
-        // Apply movement if collision check passes
-        // Check for collision at the new position
-        int newX = enemy->position.x + moveX;
-        int newY = enemy->position.y + moveY;
-        
-        // Check for collision only if mask is provided
-        if (mask != NULL) {
-            if (newX >= 0 && newX < mask->w && newY >= 0 && newY < mask->h) {
-                Uint32 pixel;
-                int bpp = mask->format->BytesPerPixel;
-                Uint8 *p = (Uint8 *)mask->pixels + newY * mask->pitch + newX * bpp;
-                pixel = *(Uint32 *)p;
-                
-                // If pixel is not black (collision), don't move
-                if (pixel != 0) {
-                    enemy->position.x = newX;
-                    enemy->position.y = newY;
+        // Steer away from walls before touching them
+        if (map != NULL) {
+            int cx = enemy->position.x + enemy->position.w / 2;
+            int cy = enemy->position.y + enemy->position.h / 2;
+            if (collision_clearance(map, cx, cy) < rayon_ennemi(enemy) + ENEMY_STEER_MARGIN) {
+                int gx, gy;
+                collision_gradient(map, cx, cy, &gx, &gy);
+                int norm = abs(gx) + abs(gy);
+                if (norm > 0) {
+                    moveX += gx * step / norm;
+                    moveY += gy * step / norm;
                 }
             }
-        } else {
-            // No collision mask provided, move freely
-            enemy->position.x = newX;
-            enemy->position.y = newY;
         }
         
+        // Apply movement with proper collision check
+        deplacer_ennemi(enemy, moveX, moveY, map);
+        
         // Update ES position
         if (enemy->es_active) {
             enemy->es_position.x = enemy->position.x;
@@ -261,17 +355,21 @@ void moveEnemyAI(Enemy *enemy, SDL_Rect player_pos, SDL_Surface *mask) {
         
         // If close enough to player, activate ES
         if (distance < enemy->attack_range) {
-            activateES(enemy);
+            activateES(enemy, timers);
         }
     } else {
         // Default to random patrol movement if player is not in range
-        moveEnemy(enemy, mask);
+        moveEnemy(enemy, map, frames);
     }
 }
 
 // Update enemy state based on health
 void updateEnemyState(Enemy *enemy) {
     if (enemy->health <= 0) {
+        if (enemy->state != NEUTRALIZED) {
+            emit_particles(enemy->position.x + enemy->position.w / 2, enemy->position.y + enemy->position.h / 2,
+                           ENEMY_DEATH_PARTICLES, 200, PARTICLE_DEATH, 900);
+        }
         enemy->state = NEUTRALIZED;
     } else if (enemy->health < enemy->max_health / 2) {
         enemy->state = WOUNDED;
@@ -281,17 +379,27 @@ void updateEnemyState(Enemy *enemy) {
 }
 
 // Check for collision with player
-int checkCollisionWithPlayer(Enemy *enemy, SDL_Rect player_pos) {
+int checkCollisionWithPlayer(Enemy *enemy, WorldRect player_pos, const SpriteFrame *player_frame, const SpriteMask *player_mask) {
     if (enemy->state == NEUTRALIZED) {
         return 0; // No collision with neutralized enemies
     }
     
-    // Simple bounding box collision
+    // Bounding box first, then the opaque pixels of both current frames
     if (enemy->position.x + enemy->position.w > player_pos.x &&
         enemy->position.x < player_pos.x + player_pos.w &&
         enemy->position.y + enemy->position.h > player_pos.y &&
         enemy->position.y < player_pos.y + player_pos.h) {
-        return 1; // Collision detected with enemy
+        if (player_frame == NULL || player_mask == NULL) {
+            return 1; // No mask for the player: bounding boxes only
+        }
+        
+        const SpriteFrame *frame = &enemy->animation[enemy->state][enemy->frame_current];
+        if (sprite_masks_overlap(&enemy->masks[enemy->state][enemy->frame_current],
+                                 enemy->position.x + frame->offset_x, enemy->position.y + frame->offset_y,
+                                 player_mask,
+                                 player_pos.x + player_frame->offset_x, player_pos.y + player_frame->offset_y)) {
+            return 1; // Collision detected with enemy
+        }
     }
     
     // Check for ES collision if active
@@ -316,8 +424,8 @@ void damageEnemy(Enemy *enemy, int damage) {
     updateEnemyState(enemy);
 }
 
-// Activate enemy's ES
-void activateES(Enemy *enemy) {
+// Activate enemy's ES for ENEMY_ES_DURATION ms (restarted while the player stays close)
+void activateES(Enemy *enemy, TimerWheel *timers) {
     enemy->es_active = 1;
-    // You could add a timer here to deactivate ES after a period
+    timer_start(timers, &enemy->es_timer, ENEMY_ES_DURATION, 0);
 }
\ No newline at end of file
@@ -3,6 +3,19 @@
 
 #include <SDL/SDL.h>
 #include <SDL/SDL_image.h>
+#include "spritesheet.h"
+#include "hud.h"
+#include "collision.h"
+#include "timer.h"
+#include "render.h"
+
+// Distance to walls under which a chasing enemy starts steering away from them
+#define ENEMY_STEER_MARGIN 8
+
+// How long the ES stays out once activated (ms)
+#define ENEMY_ES_DURATION 3000
+// Particles of the burst when the enemy is neutralized
+#define ENEMY_DEATH_PARTICLES 120
 
 // Direction enumeration for enemy movement
 typedef enum {
@@ -29,8 +42,9 @@ typedef enum {
 // Enemy structure
 typedef struct {
     SDL_Surface *sprite;          // Enemy sprite sheet
-    SDL_Rect position;            // Current position
-    SDL_Rect animation[3][4];     // Animation frames [state][direction]
+    WorldRect position;           // Current position in the world
+    SpriteFrame animation[3][4];  // Trimmed animation frames [state][frame]
+    SpriteMask masks[3][4];       // Opacity masks of the frames, for pixel-perfect collisions
     
     EnemyDirection direction;     // Current direction
     EnemyState state;             // Current state (alive, wounded, neutralized)
@@ -42,32 +56,37 @@ typedef struct {
     
     int frame_current;            // Current animation frame
     int frame_count;              // Total frames in animation
-    int frame_delay;              // Delay between frame changes
-    int frame_timer;              // Timer for animation
+    int frame_delay;              // Milliseconds between frame changes
+    Timer frame_timer;            // Fires the next frame change (armed by animateEnemy)
     
     int move_speed;               // Movement speed
     int detect_range;             // Detection range for player
     int attack_range;             // Range for attacking player
     
-    SDL_Rect patrol_points[2];    // Patrol points for random movement
+    WorldRect patrol_points[2];   // Patrol points for random movement
     int current_patrol_point;     // Current patrol point index
     
     // ES (Special Entity) associated with this enemy
     SDL_Surface *es_sprite;       // ES sprite
-    SDL_Rect es_position;         // ES position
+    WorldRect es_position;        // ES position in the world
     int es_active;                // Is ES active
+    Timer es_timer;               // Puts the ES away ENEMY_ES_DURATION ms after its activation
+    
+    HudBar health_bar;            // Cached health bar, rebuilt when health changes
 } Enemy;
 
 // Function declarations
 void initEnemy(Enemy *enemy, EnemyLevel level, int x, int y);
-void displayEnemy(SDL_Surface *screen, Enemy *enemy);
+void placeEnemy(Enemy *enemy, const CollisionMap *map);
+void displayEnemy(RenderQueue *queue, Enemy *enemy, const Camera *camera);
+WorldRect enemyBounds(const Enemy *enemy); // Everything displayEnemy may draw: sprite, health bar, ES
 void freeEnemy(Enemy *enemy);
-void animateEnemy(Enemy *enemy);
-void moveEnemy(Enemy *enemy, SDL_Surface *mask);
-void moveEnemyAI(Enemy *enemy, SDL_Rect player_pos, SDL_Surface *mask);
+void animateEnemy(Enemy *enemy, TimerWheel *timers);
+void moveEnemy(Enemy *enemy, const CollisionMap *map, int frames);
+void moveEnemyAI(Enemy *enemy, WorldRect player_pos, const CollisionMap *map, int frames, TimerWheel *timers);
 void updateEnemyState(Enemy *enemy);
-int checkCollisionWithPlayer(Enemy *enemy, SDL_Rect player_pos);
+int checkCollisionWithPlayer(Enemy *enemy, WorldRect player_pos, const SpriteFrame *player_frame, const SpriteMask *player_mask);
 void damageEnemy(Enemy *enemy, int damage);
-void activateES(Enemy *enemy);
+void activateES(Enemy *enemy, TimerWheel *timers);
 
 #endif // ENNEMIE_H
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include <SDL/SDL.h>
+#include "fixedpoint.h"
+
+// sin() of the first quarter turn, 16.16 (entry i is angle i of FIX_ANGLE_STEPS)
+static const fixed sin_quarter[FIX_ANGLE_STEPS / 4 + 1] = {
+    0, 1608, 3216, 4821, 6424, 8022, 9616, 11204,
+    12785, 14359, 15924, 17479, 19024, 20557, 22078, 23586,
+    25080, 26558, 28020, 29466, 30893, 32303, 33692, 35062,
+    36410, 37736, 39040, 40320, 41576, 42806, 44011, 45190,
+    46341, 47464, 48559, 49624, 50660, 51665, 52639, 53581,
+    54491, 55368, 56212, 57022, 57798, 58538, 59244, 59914,
+    60547, 61145, 61705, 62228, 62714, 63162, 63572, 63944,
+    64277, 64571, 64827, 65043, 65220, 65358, 65457, 65516,
+    65536
+};
+
+fixed fix_mul(fixed a, fixed b) {
+    Sint64 product = (Sint64)a * b;
+    return (fixed)(product >> FIX_SHIFT);
+}
+
+fixed fix_div(fixed a, fixed b) {
+    if (b == 0) return a >= 0 ? 0x7FFFFFFF : -0x7FFFFFFF;
+    return (fixed)((Sint64)a * FIX_ONE / b);
+}
+
+int div_round(int a, int b) {
+    return a >= 0 ? (a + b / 2) / b : -((-a + b / 2) / b);
+}
+
+// Bit by bit square root: one result bit per iteration, no division
+Uint32 isqrt64(Uint64 n) {
+    Uint64 result = 0;
+    Uint64 bit = (Uint64)1 << 62;
+
+    while (bit > n) bit >>= 2;
+    while (bit != 0) {
+        if (n >= result + bit) {
+            n -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (Uint32)result;
+}
+
+fixed fix_sqrt(fixed a) {
+    if (a <= 0) return 0;
+    return (fixed)isqrt64((Uint64)a << FIX_SHIFT);
+}
+
+fixed fix_length(fixed x, fixed y) {
+    // x * x + y * y carries 32 fractional bits, its root 16
+    Uint64 squared = (Uint64)((Sint64)x * x) + (Uint64)((Sint64)y * y);
+    Uint32 length = isqrt64(squared);
+    return length > 0x7FFFFFFF ? 0x7FFFFFFF : (fixed)length;
+}
+
+fixed fix_normalize(fixed *x, fixed *y) {
+    fixed length = fix_length(*x, *y);
+    if (length > 0) {
+        *x = fix_div(*x, length);
+        *y = fix_div(*y, length);
+    }
+    return length;
+}
+
+fixed fix_sin(int angle) {
+    angle &= FIX_ANGLE_STEPS - 1;
+
+    int quarter = FIX_ANGLE_STEPS / 4;
+    if (angle < quarter) return sin_quarter[angle];
+    if (angle < 2 * quarter) return sin_quarter[2 * quarter - angle];
+    if (angle < 3 * quarter) return -sin_quarter[angle - 2 * quarter];
+    return -sin_quarter[4 * quarter - angle];
+}
+
+fixed fix_cos(int angle) {
+    return fix_sin(angle + FIX_ANGLE_STEPS / 4);
+}
@@ -0,0 +1,38 @@
+#ifndef FIXEDPOINT_H
+#define FIXEDPOINT_H
+
+#include <SDL/SDL.h>
+
+// 16.16 fixed-point numbers: integer math only, so the simulation gives the
+// same results on every compiler and machine. Everything it reads is integer too,
+// down to the collision SDF (built with an integer distance transform).
+// Floats are only used for effects that never feed back (particles, lighting).
+typedef Sint32 fixed;
+
+#define FIX_SHIFT 16
+#define FIX_ONE (1 << FIX_SHIFT)
+#define FIX_HALF (1 << (FIX_SHIFT - 1))
+
+#define INT_TO_FIX(i) ((fixed)((i) * FIX_ONE))
+#define FIX_TO_INT(f) ((f) >> FIX_SHIFT)             // Rounds down (arithmetic shift)
+#define FIX_ROUND(f) (((f) + FIX_HALF) >> FIX_SHIFT) // Rounds to nearest
+
+// Angles: FIX_ANGLE_STEPS per turn
+#define FIX_ANGLE_STEPS 256
+
+// Arithmetic
+fixed fix_mul(fixed a, fixed b);
+fixed fix_div(fixed a, fixed b);
+int div_round(int a, int b); // a / b rounded to nearest (b > 0), same for both signs
+
+// Square roots and vectors
+Uint32 isqrt64(Uint64 n);                      // floor(sqrt(n))
+fixed fix_sqrt(fixed a);
+fixed fix_length(fixed x, fixed y);
+fixed fix_normalize(fixed *x, fixed *y);       // Makes (x, y) unit length, returns the old length
+
+// Lookup table trigonometry (angle in 1/FIX_ANGLE_STEPS of a turn)
+fixed fix_sin(int angle);
+fixed fix_cos(int angle);
+
+#endif // FIXEDPOINT_H
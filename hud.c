@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <SDL/SDL.h>
+#include <SDL/SDL_ttf.h>
+#include "hud.h"
+
+// Set up one text element at its place inside the layer
+static void init_hud_text(HudText *text, const char *label, HudTextKind kind, int x, int y) {
+    text->label = label;
+    text->kind = kind;
+    text->value = 0;
+    text->valid = 0;
+    text->cache = NULL;
+    text->pos.x = x;
+    text->pos.y = y;
+    text->pos.w = 0;
+    text->pos.h = 0;
+}
+
+void init_hud(Hud *hud, TTF_Font *font) {
+    hud->font = font;
+    hud->color.r = 255;
+    hud->color.g = 255;
+    hud->color.b = 255;
+    hud->color.unused = 255;
+
+    init_hud_text(&hud->score, "Score", HUD_NUMBER, 0, 0);
+    init_hud_text(&hud->lives, "Lives", HUD_NUMBER, 0, 30);
+    init_hud_text(&hud->time, "Time", HUD_CLOCK, 0, 60);
+
+    // Magenta never appears in the white HUD text, so it can be the transparent color
+    hud->layer = SDL_CreateRGBSurface(SDL_SWSURFACE, HUD_WIDTH, HUD_HEIGHT, 32, 0, 0, 0, 0);
+    if (hud->layer) {
+        hud->key = SDL_MapRGB(hud->layer->format, 255, 0, 255);
+        SDL_SetColorKey(hud->layer, SDL_SRCCOLORKEY | SDL_RLEACCEL, hud->key);
+    } else {
+        printf("Failed to create HUD layer: %s\n", SDL_GetError());
+    }
+    hud->dirty = 1;
+}
+
+// Re-render an element only if its value changed since the last rendering
+static void hud_text_set(Hud *hud, HudText *text, int value) {
+    if (text->valid && text->value == value) {
+        return;
+    }
+
+    text->value = value;
+    text->valid = 1;
+    hud->dirty = 1;
+
+    if (text->cache) {
+        SDL_FreeSurface(text->cache);
+        text->cache = NULL;
+    }
+    if (!hud->font) {
+        return;
+    }
+
+    char buffer[50];
+    if (text->kind == HUD_CLOCK) {
+        sprintf(buffer, "%s: %02d:%02d", text->label, value / 60, value % 60);
+    } else {
+        sprintf(buffer, "%s: %d", text->label, value);
+    }
+    text->cache = TTF_RenderText_Solid(hud->font, buffer, hud->color);
+}
+
+void hud_set_score(Hud *hud, int score) {
+    hud_text_set(hud, &hud->score, score);
+}
+
+void hud_set_lives(Hud *hud, int lives) {
+    hud_text_set(hud, &hud->lives, lives);
+}
+
+void hud_set_time(Hud *hud, int seconds) {
+    hud_text_set(hud, &hud->time, seconds);
+}
+
+void afficher_hud(Hud *hud, SDL_Surface *screen) {
+    if (!hud->layer) {
+        return;
+    }
+
+    // Recomposite the layer only when an element changed
+    if (hud->dirty) {
+        HudText *texts[3] = {&hud->score, &hud->lives, &hud->time};
+
+        SDL_FillRect(hud->layer, NULL, hud->key);
+        for (int i = 0; i < 3; i++) {
+            if (texts[i]->cache) {
+                SDL_Rect pos = texts[i]->pos;
+                SDL_BlitSurface(texts[i]->cache, NULL, hud->layer, &pos);
+            }
+        }
+        hud->dirty = 0;
+    }
+
+    SDL_Rect pos = {HUD_X, HUD_Y, 0, 0};
+    SDL_BlitSurface(hud->layer, NULL, screen, &pos);
+}
+
+void free_hud(Hud *hud) {
+    HudText *texts[3] = {&hud->score, &hud->lives, &hud->time};
+    for (int i = 0; i < 3; i++) {
+        if (texts[i]->cache) {
+            SDL_FreeSurface(texts[i]->cache);
+            texts[i]->cache = NULL;
+        }
+        texts[i]->valid = 0;
+    }
+
+    if (hud->layer) {
+        SDL_FreeSurface(hud->layer);
+        hud->layer = NULL;
+    }
+}
+
+void init_hud_bar(HudBar *bar) {
+    bar->value = -1;
+    bar->max = -1;
+    bar->cache = NULL;
+}
+
+// Red/green health bar surface, rebuilt only when health (or size) changes
+SDL_Surface* hud_bar_surface(HudBar *bar, const SDL_PixelFormat *format, int w, int h, int value, int max) {
+    if (w <= 0 || h <= 0 || max <= 0) {
+        return NULL;
+    }
+
+    if (!bar->cache || bar->value != value || bar->max != max || bar->cache->w != w || bar->cache->h != h) {
+        if (!bar->cache || bar->cache->w != w || bar->cache->h != h) {
+            if (bar->cache) SDL_FreeSurface(bar->cache);
+            bar->cache = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, format->BitsPerPixel,
+                                              format->Rmask, format->Gmask,
+                                              format->Bmask, format->Amask);
+            if (!bar->cache) return NULL;
+        }
+
+        SDL_Rect filled = {0, 0, (value * w) / max, h};
+        SDL_FillRect(bar->cache, NULL, SDL_MapRGB(bar->cache->format, 255, 0, 0)); // Red bg
+        SDL_FillRect(bar->cache, &filled, SDL_MapRGB(bar->cache->format, 0, 255, 0)); // Green fg
+        bar->value = value;
+        bar->max = max;
+    }
+
+    return bar->cache;
+}
+
+// Draw a health bar with one blit of its cached surface
+void afficher_hud_bar(HudBar *bar, SDL_Surface *screen, int x, int y, int w, int h, int value, int max) {
+    SDL_Surface *surface = hud_bar_surface(bar, screen->format, w, h, value, max);
+    if (!surface) return;
+
+    SDL_Rect pos = {x, y, 0, 0};
+    SDL_BlitSurface(surface, NULL, screen, &pos);
+}
+
+void free_hud_bar(HudBar *bar) {
+    if (bar->cache) {
+        SDL_FreeSurface(bar->cache);
+        bar->cache = NULL;
+    }
+    bar->value = -1;
+    bar->max = -1;
+}
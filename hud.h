@@ -0,0 +1,62 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include <SDL/SDL.h>
+#include <SDL/SDL_ttf.h>
+
+// HUD layer size and position on screen
+#define HUD_X 10
+#define HUD_Y 10
+#define HUD_WIDTH 320
+#define HUD_HEIGHT 100
+
+// How an element turns its value into text
+typedef enum {
+    HUD_NUMBER,                   // "Score: 120"
+    HUD_CLOCK                     // "Time: 01:25" (value in seconds)
+} HudTextKind;
+
+// Text element re-rendered only when its value changes
+typedef struct {
+    const char *label;
+    HudTextKind kind;
+    int value;                    // Last rendered value
+    int valid;                    // cache holds a rendering of value
+    SDL_Surface *cache;           // Rendered text
+    SDL_Rect pos;                 // Position inside the HUD layer
+} HudText;
+
+// Health bar whose surface is rebuilt only when health changes
+typedef struct {
+    int value;                    // Last rendered health
+    int max;
+    SDL_Surface *cache;           // Background + filled part, drawn with one blit
+} HudBar;
+
+// Retained HUD: elements are composited into one layer, blitted once per frame
+typedef struct {
+    TTF_Font *font;
+    SDL_Color color;
+    HudText score;
+    HudText lives;
+    HudText time;
+    SDL_Surface *layer;           // Color-keyed composite of every text element
+    Uint32 key;                   // Transparent color of the layer
+    int dirty;                    // An element changed since the layer was composited
+} Hud;
+
+// HUD layer
+void init_hud(Hud *hud, TTF_Font *font);
+void hud_set_score(Hud *hud, int score);
+void hud_set_lives(Hud *hud, int lives);
+void hud_set_time(Hud *hud, int seconds);
+void afficher_hud(Hud *hud, SDL_Surface *screen);
+void free_hud(Hud *hud);
+
+// Health bars (drawn at world positions, outside the layer)
+void init_hud_bar(HudBar *bar);
+SDL_Surface* hud_bar_surface(HudBar *bar, const SDL_PixelFormat *format, int w, int h, int value, int max); // Cached surface, NULL if empty
+void afficher_hud_bar(HudBar *bar, SDL_Surface *screen, int x, int y, int w, int h, int value, int max);
+void free_hud_bar(HudBar *bar);
+
+#endif // HUD_H
@@ -6,63 +6,115 @@
 #include <SDL/SDL_ttf.h>
 #include <SDL/SDL_mixer.h>
 #include "joueur.h"
+#include "particles.h"
 #include "assets.h" // Include for SCREEN_WIDTH, SCREEN_HEIGHT, and path definitions
 
+// Animation names looked up in the sprite sheet metadata, indexed by PlayerState
+static const char *player_anim_names[5] = {"idle", "walk", "run", "jump", "attack"};
+
+// Frames used per state when the sheet is a plain grid without metadata
+static const int player_default_frames[5] = {10, 10, 10, 8, 6};
+
+// Animation timer callback
+static void frame_suivante_joueur(void *data) {
+    Joueur *joueur = data;
+    joueur->currentFrame = (joueur->currentFrame + 1) % joueur->frameCount;
+    
+    // An attack plays once
+    if (joueur->state == ATTACKING && joueur->currentFrame == 0) {
+        set_player_state(joueur, IDLE);
+    }
+}
+
+// Frame layout from the sheet metadata, or a 10x5 grid if there is none.
+// Returns 1 if metadata was found.
+static int charger_sheet_joueur(SpriteSheet *sheet, SDL_Surface *sprite, const char *spritePath) {
+    char metaPath[128];
+    spritesheet_meta_path(spritePath, metaPath, sizeof(metaPath));
+    if (load_spritesheet_meta(sheet, metaPath, sprite)) {
+        return 1;
+    }
+    
+    spritesheet_from_grid(sheet, sprite, 10, 5); // 10 frames per row, 5 states (rows)
+    for (int state = 0; state < 5 && state < sheet->anim_count; state++) {
+        snprintf(sheet->anims[state].name, SPRITE_ANIM_NAME_LEN, "%s", player_anim_names[state]);
+        if (sheet->anims[state].count > player_default_frames[state]) {
+            sheet->anims[state].count = player_default_frames[state]; // Grid rows are padded with unused cells
+        }
+    }
+    return 0;
+}
+
 // 1. Initialize and display player
 void initialiser_joueur(Joueur *joueur, char *name, char *spritePath) {
-    // Initialize player attributes
-    strncpy(joueur->name, name, 19);
-    joueur->name[19] = '\0';
-    joueur->score = 0;
-    joueur->lives = 3;
-    
     // Load player sprite
-    joueur->sprite = load_asset_image(spritePath);
-    if (!joueur->sprite) {
+    SDL_Surface *sprite = load_asset_image(spritePath);
+    if (!sprite) {
         fprintf(stderr, "Could not load player sprite: %s\n", IMG_GetError());
         // Create a fallback sprite instead of exiting
-        joueur->sprite = SDL_CreateRGBSurface(SDL_SWSURFACE, 640, 320, 32, 0, 0, 0, 0); // 10x5 frames
-        SDL_FillRect(joueur->sprite, NULL, SDL_MapRGB(joueur->sprite->format, 0, 255, 0)); // Green fallback
+        sprite = SDL_CreateRGBSurface(SDL_SWSURFACE, 640, 320, 32, 0, 0, 0, 0); // 10x5 frames
+        SDL_FillRect(sprite, NULL, SDL_MapRGB(sprite->format, 0, 255, 0)); // Green fallback
         printf("Using fallback player sprite\n");
     }
     
+    SpriteSheet sheet;
+    charger_sheet_joueur(&sheet, sprite, spritePath);
+    initialiser_joueur_sprite(joueur, name, sprite, &sheet);
+}
+
+// Initialize a player from an already loaded (or composed) sheet; the player owns the sprite
+void initialiser_joueur_sprite(Joueur *joueur, char *name, SDL_Surface *sprite, const SpriteSheet *sheet) {
+    // Initialize player attributes
+    strncpy(joueur->name, name, 19);
+    joueur->name[19] = '\0';
+    joueur->score = 0;
+    joueur->lives = 3;
+    joueur->sprite = sprite;
+    
     // Set initial position
     joueur->position.x = 100;
     joueur->position.y = 300;
-    joueur->position.w = joueur->sprite->w / 10; // Assuming 10 frames per row
-    joueur->position.h = joueur->sprite->h / 5;  // Assuming 5 states (rows)
-    
-    // Camera setup
-    joueur->camera.x = 0;
-    joueur->camera.y = 0;
-    joueur->camera.w = 800; // Default screen width
-    joueur->camera.h = 600; // Default screen height
-    
-    // Animation setup - setup animation frames based on sprite sheet
-    int frameWidth = joueur->sprite->w / 10;
-    int frameHeight = joueur->sprite->h / 5;
+    joueur->position.w = sheet->cell_w; // Untrimmed frame size is the player's bounding box
+    joueur->position.h = sheet->cell_h;
     
+    // Animation setup - resolve each state's frame list from the sheet
     for (int state = 0; state < 5; state++) {
+        int anim = spritesheet_find_anim(sheet, player_anim_names[state]);
+        if (anim < 0) anim = state < sheet->anim_count ? state : 0;
+        
+        int count = sheet->anims[anim].count;
+        if (count > 10) count = 10;
+        
+        for (int frame = 0; frame < 10; frame++) {
+            joueur->frames[state][frame] = sheet->frames[sheet->anims[anim].frames[frame < count ? frame : 0]];
+        }
+        joueur->frameCounts[state] = count > 0 ? count : 1;
+        
+        // Opacity masks of the frames that can be shown
         for (int frame = 0; frame < 10; frame++) {
-            joueur->frames[state][frame].x = frame * frameWidth;
-            joueur->frames[state][frame].y = state * frameHeight;
-            joueur->frames[state][frame].w = frameWidth;
-            joueur->frames[state][frame].h = frameHeight;
+            if (frame < joueur->frameCounts[state]) {
+                build_sprite_mask(&joueur->masks[state][frame], sprite, &joueur->frames[state][frame]);
+            } else {
+                joueur->masks[state][frame].bits = NULL;
+            }
         }
     }
     
     // Animation state
     joueur->currentFrame = 0;
-    joueur->frameCount = 10;    // Default 10 frames per animation
+    joueur->frameCount = joueur->frameCounts[IDLE];
     joueur->frameDelay = 100;   // Milliseconds between frames
-    joueur->frameTimer = SDL_GetTicks();
+    init_timer(&joueur->animTimer, frame_suivante_joueur, joueur);
     
     // Movement and state initialization
     joueur->velocity = 0;
     joueur->jumpVelocity = 0;
+    joueur->subY = 0;
     joueur->onGround = 1;       // Start on ground
     joueur->state = IDLE;
     joueur->direction = RIGHT;
+    joueur->attackId = 0;
+    joueur->attackHitbox = POOL_NO_HANDLE;
     
     // Load sound effects if they exist
     joueur->soundJump = load_asset_sound(SOUND_PATH "jump.wav");
@@ -75,20 +127,19 @@ void initialiser_joueur(Joueur *joueur, char *name, char *spritePath) {
     }
 }
 
-void afficher_joueur(Joueur joueur, SDL_Surface *screen) {
+void afficher_joueur(Joueur joueur, RenderQueue *queue, const Camera *camera) {
+    // World position to screen, nothing to draw if the player is out of view
+    SDL_Rect dest;
+    if (!camera_to_screen(camera, joueur.position, &dest)) return;
+    
     // Current frame based on state and animation progression
-    SDL_Rect frameRect = joueur.frames[joueur.state][joueur.currentFrame];
-    SDL_Rect destRect = joueur.position;
+    const SpriteFrame *frame = &joueur.frames[joueur.state][joueur.currentFrame];
     
     // Handle flipping if player faces left
-    if (joueur.direction == LEFT) {
-        // For flipping the sprite horizontally, we need to use SDL_gfx library or create a flipped surface
-        // For now, we'll just indicate it with a different frame or color
-        SDL_BlitSurface(joueur.sprite, &frameRect, screen, &destRect);
-    } else {
-        // Normal blitting for right direction
-        SDL_BlitSurface(joueur.sprite, &frameRect, screen, &destRect);
-    }
+    // For flipping the sprite horizontally, we need to use SDL_gfx library or create a flipped surface
+    // For now both directions use the same frame; only the opaque part of the frame is blitted
+    // Sorted with the other characters by the screen y of the feet
+    render_sprite(queue, LAYER_WORLD, dest.y + joueur.position.h, joueur.sprite, frame, dest.x, dest.y);
 }
 
 // 2. Lives/Score management
@@ -117,57 +168,45 @@ void update_lives(Joueur *joueur, int change) {
     }
 }
 
-void display_stats(Joueur joueur, SDL_Surface *screen, TTF_Font *font) {
-    if (!font) {
-        fprintf(stderr, "Font not loaded for stats display.\n");
-        return;
-    }
-    
-    // Create text surfaces
-    SDL_Color textColor = {255, 255, 255, 255}; // White
-    char scoreText[50];
-    char livesText[20];
-    
-    sprintf(scoreText, "Score: %d", joueur.score);
-    sprintf(livesText, "Lives: %d", joueur.lives);
-    
-    SDL_Surface *scoreSurface = TTF_RenderText_Solid(font, scoreText, textColor);
-    SDL_Surface *livesSurface = TTF_RenderText_Solid(font, livesText, textColor);
-    
-    // Positions for text
-    SDL_Rect scorePos = {10, 10, 0, 0};
-    SDL_Rect livesPos = {10, 40, 0, 0};
-    
-    // Draw text
-    SDL_BlitSurface(scoreSurface, NULL, screen, &scorePos);
-    SDL_BlitSurface(livesSurface, NULL, screen, &livesPos);
+static void dessiner_hud(SDL_Surface *screen, void *data) {
+    afficher_hud(data, screen);
+}
+
+void display_stats(Joueur joueur, RenderQueue *queue, Hud *hud) {
+    // Text is only re-rendered when score or lives actually changed
+    hud_set_score(hud, joueur.score);
+    hud_set_lives(hud, joueur.lives);
     
-    // Free text surfaces
-    SDL_FreeSurface(scoreSurface);
-    SDL_FreeSurface(livesSurface);
+    // One blit of the retained HUD layer, when the queue is flushed
+    render_callback(queue, LAYER_UI, 0, dessiner_hud, hud);
 }
 
 // 3. Player animation
-void animer_joueur(Joueur *joueur) {
-    // Increment animation timer
-    joueur->frameTimer++;
+void animer_joueur(Joueur *joueur, const CollisionMap *map, TimerWheel *timers) {
+    // Next frame change: a one-shot timer, re-armed here once it has fired
+    if (!timer_pending(&joueur->animTimer)) {
+        joueur->animTimer.data = joueur; // Joueur is sometimes returned by value
+        timer_start(timers, &joueur->animTimer, joueur->frameDelay, 0);
+    }
     
-    // Update frame if timer exceeds delay
-    if (joueur->frameTimer > joueur->frameDelay) {
-        joueur->currentFrame = (joueur->currentFrame + 1) % joueur->frameCount;
-        joueur->frameTimer = 0;
+    // Gravity while airborne, integrated in fixed point
+    if (!joueur->onGround || joueur->jumpVelocity < 0) {
+        joueur->jumpVelocity += PLAYER_GRAVITY;
+        if (joueur->jumpVelocity > PLAYER_MAX_FALL) joueur->jumpVelocity = PLAYER_MAX_FALL;
     }
     
-    // Apply gravity for jumping
-    if (joueur->state == JUMPING) {
-        // Apply gravity to jump velocity
-        joueur->jumpVelocity += 1;
-        
-        // Apply the vertical velocity
-        deplacer_joueur(joueur, 0, joueur->jumpVelocity, NULL);
+    // Move by whole pixels, keep the fraction for the next frame
+    joueur->subY += joueur->jumpVelocity;
+    int dy = FIX_TO_INT(joueur->subY);
+    joueur->subY -= INT_TO_FIX(dy);
+    deplacer_joueur(joueur, 0, dy, map);
+    
+    if (joueur->onGround && joueur->jumpVelocity >= 0) {
+        joueur->jumpVelocity = 0;
+        joueur->subY = 0;
         
         // If on ground after movement, end jump
-        if (joueur->onGround) {
+        if (joueur->state == JUMPING) {
             set_player_state(joueur, IDLE);
         }
     }
@@ -178,31 +217,28 @@ void set_player_state(Joueur *joueur, PlayerState newState) {
     if (joueur->state != newState) {
         joueur->state = newState;
         joueur->currentFrame = 0; // Reset to first frame of new animation
+        timer_cancel(&joueur->animTimer); // Re-armed with the new delay by animer_joueur
         
-        // Adjust frame count and delay based on state
+        // Frame count comes from the sheet, delay depends on the state
+        joueur->frameCount = joueur->frameCounts[newState];
         switch (newState) {
             case IDLE:
-                joueur->frameCount = 10;
                 joueur->frameDelay = 150; // Slower idle animation
                 break;
                 
             case WALKING:
-                joueur->frameCount = 10;
                 joueur->frameDelay = 100;
                 break;
                 
             case RUNNING:
-                joueur->frameCount = 10;
                 joueur->frameDelay = 70; // Faster running animation
                 break;
                 
             case JUMPING:
-                joueur->frameCount = 8; // Fewer jump frames typically
                 joueur->frameDelay = 80;
                 break;
                 
             case ATTACKING:
-                joueur->frameCount = 6; // Fewer attack frames
                 joueur->frameDelay = 60; // Fast attack animation
                 break;
         }
@@ -210,109 +246,44 @@ void set_player_state(Joueur *joueur, PlayerState newState) {
 }
 
 // 4. Player movement
-void deplacer_joueur(Joueur *joueur, int dx, int dy, SDL_Surface *collision_mask) {
+void deplacer_joueur(Joueur *joueur, int dx, int dy, const CollisionMap *map) {
     // Calculate new position
     int newX = joueur->position.x + dx;
     int newY = joueur->position.y + dy;
     
-    // Check for collisions only if a valid collision mask is provided
-    if (collision_mask != NULL) {
-        // Boundary checks
-        if (newX < 0) newX = 0;
-        if (newX + joueur->position.w > collision_mask->w) newX = collision_mask->w - joueur->position.w;
-        
-        if (newY < 0) newY = 0;
-        if (newY + joueur->position.h > collision_mask->h) newY = collision_mask->h - joueur->position.h;
+    // Check for collisions only if a valid collision map is provided
+    if (map != NULL) {
+        WorldRect box = joueur->position;
+        CollisionHit hit;
         
-        // Check for pixel-perfect collisions if needed
-        // This is a simplified collision check - you might need more complex logic
-        // Example: check all four corners of the player's bounding box
-        int collision = 0;
-        
-        // Only run this check if we're within the bounds of the collision mask
-        if (newX >= 0 && newX < collision_mask->w && 
-            newY >= 0 && newY < collision_mask->h) {
-            
-            // Get pixel at the bottom center of the player (for ground collision)
-            Uint32 pixel;
-            int bpp = collision_mask->format->BytesPerPixel;
+        // Sweep the box along the whole move, then slide what is left along the contact.
+        // Nothing is skipped whatever the speed (fast falls used to go through floors).
+        int restX = dx, restY = dy;
+        for (int pass = 0; pass < 2 && (restX != 0 || restY != 0); pass++) {
+            int blocked = collision_sweep_aabb(map, box, restX, restY, &hit);
+            int movedX = hit.x - box.x;
+            int movedY = hit.y - box.y;
+            box.x = hit.x;
+            box.y = hit.y;
+            if (!blocked) break;
             
-            // Bottom center pixel
-            int checkX = newX + joueur->position.w / 2;
-            int checkY = newY + joueur->position.h - 1;
-            
-            if (checkX >= 0 && checkX < collision_mask->w && 
-                checkY >= 0 && checkY < collision_mask->h) {
-                
-                Uint8 *p = (Uint8 *)collision_mask->pixels + checkY * collision_mask->pitch + checkX * bpp;
-                pixel = *(Uint32 *)p;
-                
-                // If pixel is not black (collision), handle it
-                if (pixel != 0) {
-                    // For vertical movement, stop falling and set onGround
-                    if (dy > 0) {
-                        joueur->onGround = 1;
-                        joueur->jumpVelocity = 0;
-                        collision = 1;
-                    }
-                    // For upward movement, stop rising
-                    else if (dy < 0) {
-                        joueur->jumpVelocity = 0;
-                        collision = 1;
-                    }
-                }
+            // Landing stops a fall, a ceiling stops a rise
+            if (hit.normal_y < 0 && joueur->jumpVelocity > 0) {
+                emit_particles(box.x + box.w / 2, box.y + box.h, PLAYER_DUST_PARTICLES, 60, PARTICLE_DUST, 400);
             }
-            
-            // Check side collisions as well
-            // Left side center
-            checkX = newX;
-            checkY = newY + joueur->position.h / 2;
-            
-            if (checkX >= 0 && checkX < collision_mask->w && 
-                checkY >= 0 && checkY < collision_mask->h) {
-                
-                Uint8 *p = (Uint8 *)collision_mask->pixels + checkY * collision_mask->pitch + checkX * bpp;
-                pixel = *(Uint32 *)p;
-                
-                // If pixel is not black (collision), don't move horizontally
-                if (pixel != 0 && dx < 0) {
-                    collision = 1;
-                }
-            }
-            
-            // Right side center
-            checkX = newX + joueur->position.w - 1;
-            checkY = newY + joueur->position.h / 2;
-            
-            if (checkX >= 0 && checkX < collision_mask->w && 
-                checkY >= 0 && checkY < collision_mask->h) {
-                
-                Uint8 *p = (Uint8 *)collision_mask->pixels + checkY * collision_mask->pitch + checkX * bpp;
-                pixel = *(Uint32 *)p;
-                
-                // If pixel is not black (collision), don't move horizontally
-                if (pixel != 0 && dx > 0) {
-                    collision = 1;
-                }
+            if ((hit.normal_y < 0 && joueur->jumpVelocity > 0) || (hit.normal_y > 0 && joueur->jumpVelocity < 0)) {
+                joueur->jumpVelocity = 0;
             }
+            restX = hit.normal_x ? 0 : restX - movedX;
+            restY = hit.normal_y ? 0 : restY - movedY;
         }
         
-        // Apply movement only if there's no collision
-        if (!collision) {
-            joueur->position.x = newX;
-            joueur->position.y = newY;
-            
-            // If moving down and no collision, we're not on ground
-            if (dy > 0) {
-                joueur->onGround = 0;
-            }
-        } else if (dx != 0) {
-            // Allow vertical movement even if horizontal collision
-            joueur->position.y = newY;
-        } else if (dy != 0) {
-            // Allow horizontal movement even if vertical collision
-            joueur->position.x = newX;
-        }
+        joueur->position.x = box.x;
+        joueur->position.y = box.y;
+        
+        // Ground detection: any solid pixel in the row right under the feet (span lookup)
+        int below = box.y + box.h;
+        joueur->onGround = collision_row_first_solid(map, below, box.x, box.x + box.w) < box.x + box.w;
     } else {
         // No collision mask - move freely but respect screen boundaries
         if (newX >= 0 && newX + joueur->position.w <= SCREEN_WIDTH) {
@@ -330,18 +301,9 @@ void deplacer_joueur(Joueur *joueur, int dx, int dy, SDL_Surface *collision_mask
             joueur->jumpVelocity = 0;
         }
     }
-    
-    // Update camera position to follow player
-    joueur->camera.x = joueur->position.x - (SCREEN_WIDTH / 2) + (joueur->position.w / 2);
-    joueur->camera.y = joueur->position.y - (SCREEN_HEIGHT / 2) + (joueur->position.h / 2);
-    
-    // Keep camera within bounds
-    if (joueur->camera.x < 0) joueur->camera.x = 0;
-    if (joueur->camera.y < 0) joueur->camera.y = 0;
-    // You would also check against the maximum world dimensions here
 }
 
-void marcher_joueur(Joueur *joueur, PlayerDirection direction, SDL_Surface *collision_mask) {
+void marcher_joueur(Joueur *joueur, PlayerDirection direction, const CollisionMap *map) {
     // Set direction
     joueur->direction = direction;
     
@@ -353,10 +315,10 @@ void marcher_joueur(Joueur *joueur, PlayerDirection direction, SDL_Surface *coll
     int dx = (direction == RIGHT) ? moveSpeed : -moveSpeed;
     
     // Move player
-    deplacer_joueur(joueur, dx, 0, collision_mask);
+    deplacer_joueur(joueur, dx, 0, map);
 }
 
-void courir_joueur(Joueur *joueur, PlayerDirection direction, SDL_Surface *collision_mask) {
+void courir_joueur(Joueur *joueur, PlayerDirection direction, const CollisionMap *map) {
     // Set direction
     joueur->direction = direction;
     
@@ -368,13 +330,13 @@ void courir_joueur(Joueur *joueur, PlayerDirection direction, SDL_Surface *colli
     int dx = (direction == RIGHT) ? moveSpeed : -moveSpeed;
     
     // Move player
-    deplacer_joueur(joueur, dx, 0, collision_mask);
+    deplacer_joueur(joueur, dx, 0, map);
 }
 
 void sauter_joueur(Joueur *joueur) {
     // Only allow jumping when on the ground
     if (joueur->onGround) {
-        joueur->jumpVelocity = -15; // Initial upward velocity
+        joueur->jumpVelocity = PLAYER_JUMP_VELOCITY;
         joueur->onGround = 0;
         
         // Play jump sound
@@ -387,18 +349,50 @@ void sauter_joueur(Joueur *joueur) {
 }
 
 void attaquer_joueur(Joueur *joueur) {
+    // One attack at a time
+    if (joueur->state == ATTACKING) return;
+    
     // Set attack state
     set_player_state(joueur, ATTACKING);
     
     // Reset frame to beginning of attack animation
     joueur->currentFrame = 0;
+    joueur->attackId = 0; // New attack: enemies already hit can be hit again
     
     // Play attack sound if available
     if (joueur->soundAttack) {
         Mix_PlayChannel(-1, joueur->soundAttack, 0);
     }
+}
+
+// Keep the attack hitbox in front of the player during the active frames of the
+// attack, and remove it outside them; hits are resolved by combat_update
+void hitbox_attaque_joueur(Joueur *joueur, Combat *combat) {
+    int active = joueur->state == ATTACKING &&
+                 joueur->currentFrame >= PLAYER_ATTACK_FIRST_FRAME &&
+                 joueur->currentFrame <= PLAYER_ATTACK_LAST_FRAME;
+    if (!active) {
+        combat_remove_hitbox(combat, joueur->attackHitbox);
+        joueur->attackHitbox = POOL_NO_HANDLE;
+        return;
+    }
     
-    // Attack logic would go here (checking for enemies in range, etc.)
+    WorldRect box;
+    box.x = joueur->direction == RIGHT ? joueur->position.x + joueur->position.w : joueur->position.x - PLAYER_ATTACK_REACH;
+    box.y = joueur->position.y + joueur->position.h / 4;
+    box.w = PLAYER_ATTACK_REACH;
+    box.h = joueur->position.h / 2;
+    
+    // Two ticks of life, refreshed every tick: it goes away by itself if the player
+    // stops refreshing it (reset, game over...)
+    Hitbox *hitbox = combat_hitbox(combat, joueur->attackHitbox);
+    if (hitbox) {
+        hitbox->box = box; // Follows the player
+        hitbox->ticks = 2;
+    } else {
+        if (joueur->attackId == 0) joueur->attackId = combat_new_attack(combat);
+        joueur->attackHitbox = combat_spawn_hitbox(combat, box, PLAYER_ATTACK_DAMAGE, joueur->attackId, 2);
+    }
 }
 
 // 5. Second player initialization - similar to first player but with different defaults
@@ -427,21 +421,32 @@ void init_character_select(CharacterSelectMenu *menu) {    // Load menu backgrou
     for (int i = 0; i < 4; i++) {
         char path[100];
         sprintf(path, "%scharacter_%d.png", TEXTURE_PATH, i+1);
-        menu->characterSprites[i] = load_asset_image(path);
+        menu->characterSprites[i] = load_asset_image_indexed(path);
         
         if (!menu->characterSprites[i]) {
             fprintf(stderr, "Could not load character sprite %d: %s\n", i+1, IMG_GetError());
-        }        // Load clothing options for each character
+        }
+        
+        // One indexed clothing layer per character; outfits only differ by palette
+        sprintf(path, "%scharacter_%d_clothing.png", TEXTURE_PATH, i+1);
+        menu->clothingSheets[i] = load_asset_image_indexed(path);
+        if (!menu->clothingSheets[i]) {
+            fprintf(stderr, "Could not load clothing layer for character %d\n", i+1);
+        }
+        
         for (int j = 0; j < 3; j++) {
-            sprintf(path, "%scharacter_%d_clothing_%d.png", TEXTURE_PATH, i+1, j+1);
-            menu->clothingOptions[i][j] = load_asset_image(path);
+            sprintf(path, "%scharacter_%d_clothing_%d.pal", TEXTURE_PATH, i+1, j+1);
+            menu->clothingPalettes[i][j] = malloc(256 * sizeof(SDL_Color));
+            menu->clothingPaletteSizes[i][j] = load_asset_palette(path, menu->clothingPalettes[i][j], 256);
             
-            if (!menu->clothingOptions[i][j]) {
-                fprintf(stderr, "Could not load clothing option %d for character %d: %s\n", 
-                        j+1, i+1, IMG_GetError());
+            if (menu->clothingPaletteSizes[i][j] == 0) {
+                fprintf(stderr, "Could not load clothing palette %d for character %d\n", j+1, i+1);
             }
         }
         
+        menu->composited[i] = NULL;
+        menu->compositedClothing[i] = -1;
+        
         // Set positions for character display
         menu->positions[i].x = 150 + (i * 200);
         menu->positions[i].y = 250;
@@ -456,6 +461,39 @@ void init_character_select(CharacterSelectMenu *menu) {    // Load menu backgrou
     // Controls instruction position
     menu->controlsInstruction.x = 100;
     menu->controlsInstruction.y = 500;
+    
+    update_character_select_cache(menu);
+}
+
+// Swap the palette of an indexed sheet; returns 0 if the sheet cannot take it
+static int appliquer_palette(SDL_Surface *sheet, SDL_Color *colors, int count) {
+    if (!sheet || !sheet->format->palette || count <= 0) {
+        return 0;
+    }
+    return SDL_SetColors(sheet, colors, 0, count);
+}
+
+// Expand each visible character with the selected outfit into a 32bpp cache,
+// only when the selection changed
+void update_character_select_cache(CharacterSelectMenu *menu) {
+    for (int i = 0; i < 4; i++) {
+        int clothing = menu->selectedClothing;
+        if (!menu->characterSprites[i] || menu->compositedClothing[i] == clothing) {
+            continue;
+        }
+        
+        // Changing outfit is just a palette change on the shared clothing layer
+        SDL_Surface *layer = menu->clothingSheets[i];
+        if (!appliquer_palette(layer, menu->clothingPalettes[i][clothing], menu->clothingPaletteSizes[i][clothing])) {
+            layer = clothing == 0 ? layer : NULL; // Without palettes only the original outfit exists
+        }
+        
+        if (menu->composited[i]) {
+            SDL_FreeSurface(menu->composited[i]);
+        }
+        menu->composited[i] = compose_sprite_layers(menu->characterSprites[i], layer);
+        menu->compositedClothing[i] = menu->composited[i] ? menu->selectedClothing : -1;
+    }
 }
 
 void display_character_select(CharacterSelectMenu menu, SDL_Surface *screen) {
@@ -483,12 +521,11 @@ void display_character_select(CharacterSelectMenu menu, SDL_Surface *screen) {
                 SDL_FillRect(screen, &highlightRect, highlightColor);
             }
             
-            // Draw character with current clothing
-            SDL_BlitSurface(menu.characterSprites[i], NULL, screen, &destRect);
-            
-            // Draw clothing if available
-            if (menu.clothingOptions[i][menu.selectedClothing]) {
-                SDL_BlitSurface(menu.clothingOptions[i][menu.selectedClothing], NULL, screen, &destRect);
+            // Draw character with current clothing (one blit of the composed cache)
+            if (menu.composited[i]) {
+                SDL_BlitSurface(menu.composited[i], NULL, screen, &destRect);
+            } else {
+                SDL_BlitSurface(menu.characterSprites[i], NULL, screen, &destRect);
             }
         }
     }
@@ -500,16 +537,51 @@ void display_character_select(CharacterSelectMenu menu, SDL_Surface *screen) {
 Joueur select_character(CharacterSelectMenu menu, int characterIndex, int clothingIndex) {
     Joueur selected;
     char name[20] = "Player";
+    (void)menu;
     
     // Validate indices
     if (characterIndex < 0 || characterIndex > 3) characterIndex = 0;
-    if (clothingIndex < 0 || clothingIndex > 2) clothingIndex = 0;    // Load appropriate character sprite with clothing
-    char spritePath[100];
-    sprintf(spritePath, "%scharacter_%d_clothing_%d_spritesheet.png", 
-            TEXTURE_PATH, characterIndex + 1, clothingIndex + 1);
+    if (clothingIndex < 0 || clothingIndex > 2) clothingIndex = 0;
+    
+    // Load the character's base sheet and the indexed clothing layer drawn over it;
+    // the outfit is selected by its palette
+    char basePath[100], clothingPath[100], palettePath[100];
+    sprintf(basePath, "%scharacter_%d_spritesheet.png", TEXTURE_PATH, characterIndex + 1);
+    sprintf(clothingPath, "%sclothing_spritesheet.png", TEXTURE_PATH);
+    sprintf(palettePath, "%sclothing_%d.pal", TEXTURE_PATH, clothingIndex + 1);
+    
+    SDL_Surface *base = load_asset_image_indexed(basePath);
+    SDL_Surface *clothing = load_asset_image_indexed(clothingPath);
+    
+    SDL_Color palette[256];
+    int paletteSize = load_asset_palette(palettePath, palette, 256);
+    if (!appliquer_palette(clothing, palette, paletteSize) && clothingIndex != 0 && clothing) {
+        SDL_FreeSurface(clothing); // Other outfits only exist as palettes
+        clothing = NULL;
+    }
+    if (!base) {
+        // No sheet to compose - fall back to the default player
+        if (clothing) SDL_FreeSurface(clothing);
+        initialiser_joueur(&selected, name, PLAYER_SPRITE_PATH);
+        return selected;
+    }
     
-    // Initialize player with selected appearance
-    initialiser_joueur(&selected, name, spritePath);
+    // Compose both layers once; the player then blits a single sheet every frame
+    SDL_Surface *composed = compose_sprite_layers(base, clothing);
+    if (!composed) {
+        composed = base;
+        base = NULL;
+    }
+    
+    // The base sheet's metadata describes the frames; trims are recomputed for the clothing
+    SpriteSheet sheet;
+    if (charger_sheet_joueur(&sheet, composed, basePath)) {
+        spritesheet_retrim(&sheet, composed);
+    }
+    initialiser_joueur_sprite(&selected, name, composed, &sheet);
+    
+    if (base) SDL_FreeSurface(base);
+    if (clothing) SDL_FreeSurface(clothing);
     
     return selected;
 }
@@ -528,12 +600,22 @@ void free_character_select(CharacterSelectMenu *menu) {
             menu->characterSprites[i] = NULL;
         }
         
+        if (menu->clothingSheets[i]) {
+            SDL_FreeSurface(menu->clothingSheets[i]);
+            menu->clothingSheets[i] = NULL;
+        }
+        
         for (int j = 0; j < 3; j++) {
-            if (menu->clothingOptions[i][j]) {
-                SDL_FreeSurface(menu->clothingOptions[i][j]);
-                menu->clothingOptions[i][j] = NULL;
-            }
+            free(menu->clothingPalettes[i][j]);
+            menu->clothingPalettes[i][j] = NULL;
+            menu->clothingPaletteSizes[i][j] = 0;
         }
+        
+        if (menu->composited[i]) {
+            SDL_FreeSurface(menu->composited[i]);
+            menu->composited[i] = NULL;
+        }
+        menu->compositedClothing[i] = -1;
     }
 }
 
@@ -550,10 +632,12 @@ void handle_character_select_input(CharacterSelectMenu *menu, SDL_Event event, i
                 
             case SDLK_UP:
                 menu->selectedClothing = (menu->selectedClothing + 2) % 3;
+                update_character_select_cache(menu);
                 break;
                 
             case SDLK_DOWN:
                 menu->selectedClothing = (menu->selectedClothing + 1) % 3;
+                update_character_select_cache(menu);
                 break;
                 
             case SDLK_RETURN:
@@ -568,52 +652,30 @@ void handle_character_select_input(CharacterSelectMenu *menu, SDL_Event event, i
 }
 
 // Collision detection
-int collision_joueur_obstacle(Joueur joueur, SDL_Surface *mask) {
-    // This function should check if the player collides with obstacles
-    // We'll use the same approach as used in the minimap.c file
-
-    // Check multiple points around the player's bounding box
-    int collisionPoints[][2] = {
-        {0, 0},                    // Top-left
-        {joueur.position.w/2, 0},  // Top-center
-        {joueur.position.w, 0},    // Top-right
-        {0, joueur.position.h/2},  // Middle-left
-        {joueur.position.w, joueur.position.h/2}, // Middle-right
-        {0, joueur.position.h},    // Bottom-left
-        {joueur.position.w/2, joueur.position.h}, // Bottom-center
-        {joueur.position.w, joueur.position.h}    // Bottom-right
-    };
-    
-    // Function to get pixel color from minimap.c
-    extern SDL_Color GetPixel(SDL_Surface *Background, int x, int y);
-    
-    // Check collision at each point
-    for (int i = 0; i < 8; i++) {
-        int x = joueur.position.x + collisionPoints[i][0];
-        int y = joueur.position.y + collisionPoints[i][1];
-        
-        // Make sure we're within the mask bounds
-        if (x >= 0 && y >= 0 && x < mask->w && y < mask->h) {
-            SDL_Color pixel = GetPixel(mask, x, y);
-            
-            // Black pixels (RGB 0,0,0) represent obstacles
-            if (pixel.r == 0 && pixel.g == 0 && pixel.b == 0) {
-                return 1; // Collision detected
-            }
-        }
-    }
-    
-    return 0; // No collision
+int collision_joueur_obstacle(Joueur joueur, const CollisionMap *map) {
+    // Whole bounding box against the packed mask, with a distance field early-out:
+    // the cost no longer depends on how many points are sampled
+    return collision_rect(map, joueur.position);
 }
 
 // Memory management
 void liberer_joueur(Joueur *joueur) {
+    // Take the animation timer off its wheel
+    timer_cancel(&joueur->animTimer);
+    
     // Free sprite
     if (joueur->sprite) {
         SDL_FreeSurface(joueur->sprite);
         joueur->sprite = NULL;
     }
     
+    // Free collision masks
+    for (int state = 0; state < 5; state++) {
+        for (int frame = 0; frame < 10; frame++) {
+            free_sprite_mask(&joueur->masks[state][frame]);
+        }
+    }
+    
     // Free sound effects
     if (joueur->soundJump) {
         Mix_FreeChunk(joueur->soundJump);
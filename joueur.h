@@ -5,6 +5,25 @@
 #include <SDL/SDL_image.h>
 #include <SDL/SDL_ttf.h>
 #include <SDL/SDL_mixer.h>
+#include "spritesheet.h"
+#include "hud.h"
+#include "collision.h"
+#include "fixedpoint.h"
+#include "timer.h"
+#include "combat.h"
+#include "render.h"
+
+// Player physics, 16.16 fixed point (pixels per frame)
+#define PLAYER_GRAVITY (FIX_ONE)              // Added to the vertical velocity every frame
+#define PLAYER_MAX_FALL INT_TO_FIX(12)        // Terminal falling speed
+#define PLAYER_JUMP_VELOCITY INT_TO_FIX(-15)  // Initial upward velocity
+
+// Melee attack: frames of the attack animation that hurt, and the area in front of the player
+#define PLAYER_ATTACK_FIRST_FRAME 2
+#define PLAYER_ATTACK_LAST_FRAME 4
+#define PLAYER_ATTACK_REACH 40
+#define PLAYER_ATTACK_DAMAGE 10
+#define PLAYER_DUST_PARTICLES 16 // Dust kicked up on landing
 
 // Player states enum
 typedef enum {
@@ -30,22 +49,26 @@ typedef struct {
 
     // Graphics and animation
     SDL_Surface *sprite;    // Current sprite sheet
-    SDL_Rect position;      // Position on screen
-    SDL_Rect camera;        // Camera focused on player
+    WorldRect position;     // Position in the world
     
     // Animation related
-    SDL_Rect frames[5][10]; // Animation frames [state][frame]
+    SpriteFrame frames[5][10]; // Trimmed animation frames [state][frame]
+    int frameCounts[5];     // Number of frames available per state
+    SpriteMask masks[5][10]; // Opacity masks of the frames, for pixel-perfect collisions
     int currentFrame;       // Current animation frame
     int frameCount;         // Total frames for current animation
-    int frameDelay;         // Delay between frame changes
-    int frameTimer;         // Timer for animation
+    int frameDelay;         // Milliseconds between frame changes
+    Timer animTimer;        // Fires the next frame change (armed by animer_joueur)
     
     // Movement and state
     int velocity;           // Horizontal velocity
-    int jumpVelocity;       // Vertical velocity for jumping
+    fixed jumpVelocity;     // Vertical velocity (16.16, pixels per frame)
+    fixed subY;             // Fraction of a pixel not applied to position.y yet
     int onGround;           // Flag if player is on ground
     PlayerState state;      // Current player state
     PlayerDirection direction; // Current facing direction
+    Uint32 attackId;        // Combat attack id of the current attack, 0 until its first hitbox
+    PoolHandle attackHitbox; // Hitbox during the attack's active frames
     
     // Sound effects
     Mix_Chunk *soundJump;
@@ -57,23 +80,25 @@ typedef struct {
 
 // 1. Initialize and display player
 void initialiser_joueur(Joueur *joueur, char *name, char *spritePath);
-void afficher_joueur(Joueur joueur, SDL_Surface *screen);
+void initialiser_joueur_sprite(Joueur *joueur, char *name, SDL_Surface *sprite, const SpriteSheet *sheet);
+void afficher_joueur(Joueur joueur, RenderQueue *queue, const Camera *camera);
 
 // 2. Lives/Score management
 void update_score(Joueur *joueur, int points);
 void update_lives(Joueur *joueur, int change);
-void display_stats(Joueur joueur, SDL_Surface *screen, TTF_Font *font);
+void display_stats(Joueur joueur, RenderQueue *queue, Hud *hud);
 
 // 3. Player animation
-void animer_joueur(Joueur *joueur);
+void animer_joueur(Joueur *joueur, const CollisionMap *map, TimerWheel *timers);
 void set_player_state(Joueur *joueur, PlayerState newState);
 
 // 4. Player movement
-void deplacer_joueur(Joueur *joueur, int dx, int dy, SDL_Surface *collision_mask);
-void marcher_joueur(Joueur *joueur, PlayerDirection direction, SDL_Surface *collision_mask);
-void courir_joueur(Joueur *joueur, PlayerDirection direction, SDL_Surface *collision_mask);
+void deplacer_joueur(Joueur *joueur, int dx, int dy, const CollisionMap *map);
+void marcher_joueur(Joueur *joueur, PlayerDirection direction, const CollisionMap *map);
+void courir_joueur(Joueur *joueur, PlayerDirection direction, const CollisionMap *map);
 void sauter_joueur(Joueur *joueur);
 void attaquer_joueur(Joueur *joueur);
+void hitbox_attaque_joueur(Joueur *joueur, Combat *combat);
 
 // 5. Second player
 Joueur initialiser_joueur2(char *name, char *spritePath);
@@ -81,8 +106,12 @@ Joueur initialiser_joueur2(char *name, char *spritePath);
 // 6. Character selection submenu
 typedef struct {
     SDL_Surface *menuBg;
-    SDL_Surface *characterSprites[4]; // Different character options
-    SDL_Surface *clothingOptions[4][3]; // Different clothing per character
+    SDL_Surface *characterSprites[4]; // Different character options (8-bit indexed when available)
+    SDL_Surface *clothingSheets[4]; // One 8-bit indexed clothing layer per character
+    SDL_Color *clothingPalettes[4][3]; // Per-variant palettes applied to clothingSheets[i]
+    int clothingPaletteSizes[4][3];
+    SDL_Surface *composited[4]; // Character + selected clothing, composed once per selection
+    int compositedClothing[4]; // Clothing baked into composited[i] (-1 = none yet)
     SDL_Rect positions[4]; // Positions for each character
     int selectedCharacter;
     int selectedClothing;
@@ -90,13 +119,14 @@ typedef struct {
 } CharacterSelectMenu;
 
 void init_character_select(CharacterSelectMenu *menu);
+void update_character_select_cache(CharacterSelectMenu *menu);
 void display_character_select(CharacterSelectMenu menu, SDL_Surface *screen);
 Joueur select_character(CharacterSelectMenu menu, int characterIndex, int clothingIndex);
 void free_character_select(CharacterSelectMenu *menu);
 void handle_character_select_input(CharacterSelectMenu *menu, SDL_Event event, int *isDone);
 
 // Collision detection
-int collision_joueur_obstacle(Joueur joueur, SDL_Surface *mask);
+int collision_joueur_obstacle(Joueur joueur, const CollisionMap *map);
 
 // Memory management
 void liberer_joueur(Joueur *joueur);
@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lighting.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Grid point at or before world coordinate v (floor division, also for negative v)
+static int point_grille(int v) {
+    return v >= 0 ? v >> LIGHT_CELL_SHIFT : -((-v + LIGHT_CELL - 1) >> LIGHT_CELL_SHIFT);
+}
+
+// Add one light to a grid whose point (0, 0) is world grid point (originX, originY).
+// Quadratic falloff, so no square root: 1 - d^2 / r^2.
+static void accumuler_lumiere(Uint16 *map, int mapW, int mapH, int originX, int originY, Light light) {
+    if (light.radius <= 0) return;
+    
+    int i0 = point_grille(light.x - light.radius) + 1 - originX;
+    int i1 = point_grille(light.x + light.radius) - originX;
+    int j0 = point_grille(light.y - light.radius) + 1 - originY;
+    int j1 = point_grille(light.y + light.radius) - originY;
+    if (i0 < 0) i0 = 0;
+    if (j0 < 0) j0 = 0;
+    if (i1 >= mapW) i1 = mapW - 1;
+    if (j1 >= mapH) j1 = mapH - 1;
+    
+    Sint64 r2 = (Sint64)light.radius * light.radius;
+    for (int j = j0; j <= j1; j++) {
+        Sint64 dy = (Sint64)(originY + j) * LIGHT_CELL - light.y;
+        Uint16 *p = map + (j * mapW + i0) * 3;
+        for (int i = i0; i <= i1; i++, p += 3) {
+            Sint64 dx = (Sint64)(originX + i) * LIGHT_CELL - light.x;
+            Sint64 d2 = dx * dx + dy * dy;
+            if (d2 >= r2) continue;
+            int w = 256 - (int)(d2 * 256 / r2);
+            p[0] += light.r * w >> 8;
+            p[1] += light.g * w >> 8;
+            p[2] += light.b * w >> 8;
+        }
+    }
+}
+
+int init_lightmap(Lightmap *lm, int worldW, int worldH, int viewW, int viewH, Uint8 ambient) {
+    memset(lm, 0, sizeof(*lm));
+    lm->ambient = ambient;
+    lm->worldW = (worldW + LIGHT_CELL - 1) / LIGHT_CELL + 1;
+    lm->worldH = (worldH + LIGHT_CELL - 1) / LIGHT_CELL + 1;
+    // One extra point for the partial cell at each edge of the view, one for the interpolation
+    lm->viewW = (viewW + LIGHT_CELL - 1) / LIGHT_CELL + 2;
+    lm->viewH = (viewH + LIGHT_CELL - 1) / LIGHT_CELL + 2;
+    lm->rowW = (lm->viewW - 1) * LIGHT_CELL;
+    
+    lm->staticMap = malloc((size_t)lm->worldW * lm->worldH * 3 * sizeof(Uint16));
+    lm->viewMap = malloc((size_t)lm->viewW * lm->viewH * 3 * sizeof(Uint16));
+    lm->rows = malloc((size_t)lm->rowW * lm->viewH * sizeof(Uint32));
+    if (!lm->staticMap || !lm->viewMap || !lm->rows) {
+        printf("Out of memory for the lightmap\n");
+        free_lightmap(lm);
+        return 0;
+    }
+    
+    lm->staticDirty = 1;
+    return 1;
+}
+
+void free_lightmap(Lightmap *lm) {
+    free(lm->staticMap);
+    free(lm->viewMap);
+    free(lm->rows);
+    lm->staticMap = NULL;
+    lm->viewMap = NULL;
+    lm->rows = NULL;
+}
+
+int lightmap_add_static(Lightmap *lm, Light light) {
+    if (lm->staticCount >= LIGHT_MAX_STATIC) return 0;
+    lm->staticLights[lm->staticCount++] = light;
+    lm->staticDirty = 1;
+    return 1;
+}
+
+void lightmap_clear_static(Lightmap *lm) {
+    lm->staticCount = 0;
+    lm->staticDirty = 1;
+}
+
+int lightmap_add_dynamic(Lightmap *lm, Light light) {
+    if (lm->dynamicCount >= LIGHT_MAX_DYNAMIC) return 0;
+    lm->dynamicLights[lm->dynamicCount++] = light;
+    return 1;
+}
+
+// Ambient plus every static light, over the whole world
+static void construire_carte_statique(Lightmap *lm) {
+    int n = lm->worldW * lm->worldH * 3;
+    for (int k = 0; k < n; k++) lm->staticMap[k] = lm->ambient;
+    for (int l = 0; l < lm->staticCount; l++) {
+        accumuler_lumiere(lm->staticMap, lm->worldW, lm->worldH, 0, 0, lm->staticLights[l]);
+    }
+    lm->staticDirty = 0;
+}
+
+// Light of the view: the cached static part, then the dynamic lights on top
+static void construire_carte_vue(Lightmap *lm, int c0, int r0) {
+    for (int j = 0; j < lm->viewH; j++) {
+        Uint16 *dst = lm->viewMap + j * lm->viewW * 3;
+        int gy = r0 + j;
+        for (int i = 0; i < lm->viewW; i++, dst += 3) {
+            int gx = c0 + i;
+            if (gx >= 0 && gy >= 0 && gx < lm->worldW && gy < lm->worldH) {
+                const Uint16 *src = lm->staticMap + (gy * lm->worldW + gx) * 3;
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2];
+            } else {
+                dst[0] = dst[1] = dst[2] = lm->ambient;
+            }
+        }
+    }
+    for (int l = 0; l < lm->dynamicCount; l++) {
+        accumuler_lumiere(lm->viewMap, lm->viewW, lm->viewH, c0, r0, lm->dynamicLights[l]);
+    }
+}
+
+// Interpolate every grid row along x, packed with the screen's channel layout
+// (the bits outside the color channels stay at 255 so multiplying keeps them)
+static void interpoler_lignes(Lightmap *lm, const SDL_PixelFormat *fmt) {
+    Uint32 base = ~(fmt->Rmask | fmt->Gmask | fmt->Bmask);
+    for (int j = 0; j < lm->viewH; j++) {
+        const Uint16 *p = lm->viewMap + j * lm->viewW * 3;
+        Uint32 *row = lm->rows + j * lm->rowW;
+        for (int i = 0; i < lm->viewW - 1; i++, p += 3) {
+            for (int k = 0; k < LIGHT_CELL; k++) {
+                int r = (p[0] * (LIGHT_CELL - k) + p[3] * k) >> LIGHT_CELL_SHIFT;
+                int g = (p[1] * (LIGHT_CELL - k) + p[4] * k) >> LIGHT_CELL_SHIFT;
+                int b = (p[2] * (LIGHT_CELL - k) + p[5] * k) >> LIGHT_CELL_SHIFT;
+                if (r > 255) r = 255;
+                if (g > 255) g = 255;
+                if (b > 255) b = 255;
+                *row++ = base | (Uint32)r << fmt->Rshift | (Uint32)g << fmt->Gshift | (Uint32)b << fmt->Bshift;
+            }
+        }
+    }
+}
+
+// dst *= lerp(a, b, t / 256), byte by byte, over count pixels
+static void multiplier_ligne(Uint32 *dst, const Uint32 *a, const Uint32 *b, int t, int count) {
+    int x = 0;
+#ifdef __SSE2__
+    __m128i zero = _mm_setzero_si128();
+    __m128i wa = _mm_set1_epi16((short)(256 - t));
+    __m128i wb = _mm_set1_epi16((short)t);
+    for (; x + 4 <= count; x += 4) {
+        __m128i la = _mm_loadu_si128((const __m128i *)(a + x));
+        __m128i lb = _mm_loadu_si128((const __m128i *)(b + x));
+        __m128i p = _mm_loadu_si128((const __m128i *)(dst + x));
+        
+        // At most 255 * 256 per 16-bit lane, so the sums cannot overflow
+        __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(la, zero), wa),
+                                                  _mm_mullo_epi16(_mm_unpacklo_epi8(lb, zero), wb)), 8);
+        __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(la, zero), wa),
+                                                  _mm_mullo_epi16(_mm_unpackhi_epi8(lb, zero), wb)), 8);
+        lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(p, zero), lo), 8);
+        hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(p, zero), hi), 8);
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; x < count; x++) {
+        Uint32 out = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            Uint32 l = (((a[x] >> shift) & 0xFF) * (256 - t) + ((b[x] >> shift) & 0xFF) * t) >> 8;
+            out |= (((dst[x] >> shift) & 0xFF) * l >> 8) << shift;
+        }
+        dst[x] = out;
+    }
+}
+
+void lightmap_apply(Lightmap *lm, SDL_Surface *screen, const Camera *camera) {
+    // 32-bit surfaces with 8-bit channels only (the game screen)
+    SDL_PixelFormat *fmt = screen->format;
+    if (!lm->rows || fmt->BytesPerPixel != 4 || fmt->Rloss || fmt->Gloss || fmt->Bloss) {
+        lm->dynamicCount = 0;
+        return;
+    }
+    
+    if (lm->staticDirty) construire_carte_statique(lm);
+    
+    // The grid stays aligned on world coordinates, so the static cache is copied as is
+    int c0 = point_grille(camera->x);
+    int r0 = point_grille(camera->y);
+    construire_carte_vue(lm, c0, r0);
+    lm->dynamicCount = 0;
+    interpoler_lignes(lm, fmt);
+    
+    int w = camera->w < screen->w ? camera->w : screen->w;
+    int h = camera->h < screen->h ? camera->h : screen->h;
+    if (w > lm->rowW - LIGHT_CELL) w = lm->rowW - LIGHT_CELL;
+    if (h > (lm->viewH - 2) * LIGHT_CELL) h = (lm->viewH - 2) * LIGHT_CELL;
+    int ox = camera->x - c0 * LIGHT_CELL;
+    int oy = camera->y - r0 * LIGHT_CELL;
+    
+    if (SDL_MUSTLOCK(screen) && SDL_LockSurface(screen) < 0) return;
+    
+    for (int y = 0; y < h; y++) {
+        int gy = oy + y;
+        const Uint32 *a = lm->rows + (gy >> LIGHT_CELL_SHIFT) * lm->rowW + ox;
+        int t = (gy & (LIGHT_CELL - 1)) << (8 - LIGHT_CELL_SHIFT);
+        Uint32 *dst = (Uint32 *)((Uint8 *)screen->pixels + y * screen->pitch);
+        multiplier_ligne(dst, a, a + lm->rowW, t, w);
+    }
+    
+    if (SDL_MUSTLOCK(screen)) SDL_UnlockSurface(screen);
+}
@@ -0,0 +1,59 @@
+#ifndef LIGHTING_H
+#define LIGHTING_H
+
+#include <SDL/SDL.h>
+#include "camera.h"
+
+// Darkness overlay: light is accumulated on a coarse grid of world points, then
+// interpolated and multiplied into the frame (SSE2, 4 pixels at a time)
+#define LIGHT_CELL_SHIFT 3
+#define LIGHT_CELL (1 << LIGHT_CELL_SHIFT)   // Pixels between two grid points
+#define LIGHT_MAX_STATIC 64
+#define LIGHT_MAX_DYNAMIC 32
+#define LIGHT_AMBIENT 48                     // Light everywhere, 0 (black) to 255 (fully lit)
+
+// Point light, fading to nothing at radius
+typedef struct {
+    int x;                        // World position
+    int y;
+    int radius;
+    Uint8 r;
+    Uint8 g;
+    Uint8 b;
+} Light;
+
+typedef struct {
+    // Static lights and their cached contribution over the whole world (plus ambient),
+    // rebuilt only when the static lights change
+    Light staticLights[LIGHT_MAX_STATIC];
+    int staticCount;
+    int staticDirty;
+    int worldW;                   // World size in grid points
+    int worldH;
+    Uint16 *staticMap;            // r, g, b per grid point
+    
+    // Dynamic lights, submitted every frame and dropped by lightmap_apply
+    Light dynamicLights[LIGHT_MAX_DYNAMIC];
+    int dynamicCount;
+    
+    // Per frame buffers covering the view
+    int viewW;                    // View size in grid points
+    int viewH;
+    Uint16 *viewMap;              // r, g, b per grid point
+    Uint32 *rows;                 // Grid rows interpolated to pixels, packed like the screen
+    int rowW;                     // Pixels per interpolated row
+    Uint8 ambient;
+} Lightmap;
+
+// Returns 0 if out of memory. The world and view sizes are in pixels.
+int init_lightmap(Lightmap *lm, int worldW, int worldH, int viewW, int viewH, Uint8 ambient);
+void free_lightmap(Lightmap *lm);
+
+int lightmap_add_static(Lightmap *lm, Light light);   // Returns 0 if full
+void lightmap_clear_static(Lightmap *lm);
+int lightmap_add_dynamic(Lightmap *lm, Light light);  // For the next lightmap_apply only
+
+// Darken the 32-bit screen by the light of the camera's view
+void lightmap_apply(Lightmap *lm, SDL_Surface *screen, const Camera *camera);
+
+#endif // LIGHTING_H
@@ -16,6 +16,13 @@
 #include "ennemie.h"
 #include "minimap.h"
 #include "background.h"
+#include "atlas.h"
+#include "ai.h"
+#include "sequence.h"
+#include "combat.h"
+#include "particles.h"
+#include "lighting.h"
+#include "render.h"
 
 // Game states
 typedef enum {
@@ -26,10 +33,65 @@ typedef enum {
     STATE_GAMEOVER
 } GameState;
 
+// Longest game time step of one frame (ms)
+#define MAX_FRAME_STEP 100
+
+// Lights of the dark level (pixels)
+#define LANTERN_SPACING 700
+#define PLAYER_LIGHT_RADIUS 220
+#define ES_LIGHT_RADIUS 90
+
+// Knockback after touching an enemy: the push is spread over a few frames,
+// then the player can't be hurt again for a short while
+#define KNOCKBACK_FRAMES 6
+#define KNOCKBACK_DISTANCE 30
+#define KNOCKBACK_LIFT 10
+#define KNOCKBACK_GRACE 500     // ms
+
+typedef struct {
+    Joueur *joueur;
+    const CollisionMap *map;
+    int direction;              // -1 pushes left, 1 pushes right
+    int frame;
+    int active;                 // Set until the grace period is over
+} Knockback;
+
+// Game over screen: lines appear one by one, then ENTER goes back to the menu
+#define GAMEOVER_LINES 3        // Title, score, instruction
+#define GAMEOVER_LINE_DELAY 400 // ms
+
+typedef struct {
+    int lines;                  // Lines shown so far
+    int confirmed;              // ENTER pressed once every line is shown
+    GameState *gameState;
+    MenuState *menuState;
+    Joueur *joueur;
+} GameOverScreen;
+
+// Full screen passes and UI drawn at their place in the render queue
+typedef struct {
+    Lightmap *lightmap;
+    const Camera *camera;
+} LightingPass;
+
+typedef struct {
+    minimap *mini;
+    int markerX[3];             // Enemy and enigme triggers, in world coordinates
+    int markerY[3];
+    Uint8 markerTypes[3];
+    int markerCount;
+} MinimapPass;
+
 // Function prototypes
 int init_SDL();
 void cleanup_SDL();
 SDL_Surface* load_image(const char* filename);
+static int sequence_knockback(Sequence *seq);
+static int sequence_game_over(Sequence *seq);
+static int hauteur_sol(const CollisionMap *map, int x, int fallback);
+static void dessiner_lumieres(SDL_Surface *screen, void *data);
+static void dessiner_particules(SDL_Surface *screen, void *data);
+static void dessiner_minimap(SDL_Surface *screen, void *data);
 
 int main(int argc, char *argv[]) {
     // Suppress unused parameter warnings
@@ -60,6 +122,9 @@ int main(int argc, char *argv[]) {
     }
     SDL_WM_SetCaption("Mon Jeu", NULL);
 
+    // Decode the texture atlas once; packed images resolve to sub-rects of it
+    init_atlas(); // Optional - images are loaded one by one without it
+
     // Initialize menu system with our screen
     if (!init_menu(screen)) {
         printf("Failed to initialize menu system\n");
@@ -88,6 +153,16 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
+    // Camera over the level: entities live in 32-bit world coordinates and are
+    // converted to screen rectangles only when drawn
+    // The view is the real video surface, whatever size SDL gave us
+    Camera camera;
+    init_camera(&camera, screen->w, screen->h, background->w, background->h);
+
+    // Every frame is submitted to the render queue, then drawn sorted by layer and depth
+    RenderQueue renderQueue;
+    init_render_queue(&renderQueue, screen->format);
+
     // Init game elements    // Player initialization
     Joueur joueur;
     initialiser_joueur(&joueur, "Player1", PLAYER_SPRITE_PATH);
@@ -96,18 +171,51 @@ int main(int argc, char *argv[]) {
     Enemy enemy;
     initEnemy(&enemy, LEVEL1, 800, 400);
 
-    // Minimap initialization
+    // Create collision mask (usually loaded from file but creating a blank one for now)
+    SDL_Surface *collision_mask = SDL_CreateRGBSurface(SDL_SWSURFACE, SCREEN_WIDTH, SCREEN_HEIGHT, 32, 0, 0, 0, 0);
+    SDL_FillRect(collision_mask, NULL, SDL_MapRGB(collision_mask->format, 0, 0, 0)); // Black = no collision
+    
+    // Packed mask and distance field used by the collision queries
+    CollisionMap collisionMap;
+    const CollisionMap *worldMap = init_collision_map(&collisionMap, collision_mask) ? &collisionMap : NULL;
+    placeEnemy(&enemy, worldMap);
+
+    // AI level of detail: enemies far from the view are updated less often
+    AiScheduler aiScheduler;
+    init_ai_scheduler(&aiScheduler);
+    ai_add_enemy(&aiScheduler, &enemy);
+
+    // Attack hitboxes against the enemies, resolved in one batch per tick
+    Combat combat;
+    if (!init_combat(&combat, background->w, background->h)) {
+        cleanup_SDL();
+        return 1;
+    }
+    combat_add_enemy(&combat, &enemy);
+
+    // Effects only: the game runs without them
+    if (!init_particles(PARTICLE_CAPACITY)) {
+        printf("Particle effects disabled\n");
+    }
+
+    // Minimap initialization (thumbnail of the level and its walls, built once)
     minimap mini;
-    initmap(&mini);
+    initmap(&mini, background, collision_mask);
 
     // Enigme initialization
     enigme en;
     SDL_Color textColor = {255, 255, 255, 255};
     init_enigme(&en, textColor);
 
-    // Create collision mask (usually loaded from file but creating a blank one for now)
-    SDL_Surface *collision_mask = SDL_CreateRGBSurface(SDL_SWSURFACE, SCREEN_WIDTH, SCREEN_HEIGHT, 32, 0, 0, 0, 0);
-    SDL_FillRect(collision_mask, NULL, SDL_MapRGB(collision_mask->format, 0, 0, 0)); // Black = no collision
+    // Retained HUD (score, lives, play time)
+    Hud hud;
+    init_hud(&hud, font);
+    Uint32 gameTicks = 0; // Time spent in the main game state
+    
+    // Game timers (animations, ES...) run on game time: they pause with the game
+    TimerWheel gameTimers;
+    init_timer_wheel(&gameTimers, gameTicks);
+    
 
     // Variables
     SDL_Event event;
@@ -117,13 +225,45 @@ int main(int argc, char *argv[]) {
     GameState gameState = STATE_MENU; // Start with menu instead of main game
     MenuState menuState = MAIN_MENU;
     
+    // Timed sequences (knockback, game over screen), resumed once per frame
+    Sequencer sequences;
+    init_sequencer(&sequences);
+    Knockback knockback = {&joueur, worldMap, 0, 0, 0};
+    GameOverScreen gameOver = {0, 0, &gameState, &menuState, &joueur};
+    
     // Enigme triggers
     int enigme1_trigger_x = 500;
     int enigme2_trigger_x = 1000;
     int trigger_range = 50;
+    // Triggers only depend on x; they are shown on the ground below them (mid-level if there is none)
+    int enigme1_trigger_y = hauteur_sol(worldMap, enigme1_trigger_x, background->h / 2);
+    int enigme2_trigger_y = hauteur_sol(worldMap, enigme2_trigger_x, background->h / 2);
+
+    // Dark level: lanterns along the level and at the enigmes are static (cached),
+    // the player's torch and the enemy ES glow are submitted every frame
+    Lightmap lightmap;
+    int lighting = init_lightmap(&lightmap, background->w, background->h, camera.w, camera.h, LIGHT_AMBIENT);
+    if (lighting) {
+        for (int x = LANTERN_SPACING / 2; x < background->w; x += LANTERN_SPACING) {
+            Light lantern = {x, background->h / 3, 220, 255, 190, 110};
+            lightmap_add_static(&lightmap, lantern);
+        }
+        Light enigme1Light = {enigme1_trigger_x, enigme1_trigger_y, 160, 120, 160, 255};
+        Light enigme2Light = {enigme2_trigger_x, enigme2_trigger_y, 160, 120, 160, 255};
+        lightmap_add_static(&lightmap, enigme1Light);
+        lightmap_add_static(&lightmap, enigme2Light);
+    }
 
     // Main game loop
+    Uint32 lastFrame = SDL_GetTicks();
     while (continuer) {
+        // Real time elapsed since the previous frame, capped so a stall doesn't
+        // fire every game timer at once
+        Uint32 now = SDL_GetTicks();
+        Uint32 frameTime = now - lastFrame;
+        if (frameTime > MAX_FRAME_STEP) frameTime = MAX_FRAME_STEP;
+        lastFrame = now;
+        
         // Process all pending events
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_QUIT) {
@@ -172,13 +312,25 @@ int main(int argc, char *argv[]) {
                             // Manual enigme trigger for testing
                             gameState = STATE_ENIGME2;
                             break;
+                        case SDLK_x:
+                            attaquer_joueur(&joueur);
+                            break;
                         default:
                             break;
                     }
                 }
             }
+            else if (gameState == STATE_GAMEOVER) {
+                // ENTER returns to the menu once the whole screen is shown
+                if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_RETURN && gameOver.lines == GAMEOVER_LINES) {
+                    gameOver.confirmed = 1;
+                }
+            }
         }
 
+        // Resume the running sequences
+        sequencer_update(&sequences, now);
+
         // Game state machine
         switch (gameState) {
             case STATE_MENU:
@@ -210,36 +362,96 @@ int main(int argc, char *argv[]) {
                 
                 // Update player based on keyboard input
                 if (keystate[SDLK_RIGHT]) {
-                    deplacer_joueur(&joueur, 5, 0, collision_mask);
+                    deplacer_joueur(&joueur, 5, 0, worldMap);
                 }
                 if (keystate[SDLK_LEFT]) {
-                    deplacer_joueur(&joueur, -5, 0, collision_mask);
+                    deplacer_joueur(&joueur, -5, 0, worldMap);
                 }
                 if (keystate[SDLK_SPACE]) {
                     sauter_joueur(&joueur);
                 }
                 
-                // Apply gravity/update jump state
-                deplacer_joueur(&joueur, 0, 5, collision_mask); // Simplified gravity
-                
-                // Update enemy with AI targeting player
-                moveEnemyAI(&enemy, joueur.position, collision_mask);
+                // Update enemies with AI targeting player, at a rate that depends on their distance to the view
+                ai_update(&aiScheduler, &camera, joueur.position, worldMap, &gameTimers);
                 
                 // Update minimap based on player position
-                MAJMinimap(joueur.position, &mini, joueur.camera, 5);
+                MAJMinimap(joueur.position, &mini);
                 
                 // Animate characters
-                animer_joueur(&joueur);
-                animateEnemy(&enemy);
+                animer_joueur(&joueur, worldMap, &gameTimers); // Also applies gravity, so it runs even out of view
+                
+                // Attack hitboxes follow their owners, then every hit of the tick is applied at once
+                hitbox_attaque_joueur(&joueur, &combat);
+                combat_update(&combat);
+                
+                // Follow the player once everything has moved this frame
+                camera_follow(&camera, joueur.position);
+                
+                // Cull every drawable against the view in one pass; only what is
+                // visible gets its animation stepped and is submitted for blitting
+                enum { DRAW_PLAYER, DRAW_ENEMY, DRAW_COUNT };
+                WorldRect drawBounds[DRAW_COUNT];
+                int visible[DRAW_COUNT];
+                drawBounds[DRAW_PLAYER] = joueur.position;
+                drawBounds[DRAW_ENEMY] = enemyBounds(&enemy);
+                int visibleCount = camera_cull(&camera, drawBounds, DRAW_COUNT, visible);
+                
+                // Submit game elements
+                SDL_Rect view = {camera.x, camera.y, camera.w, camera.h};
+                render_blit(&renderQueue, LAYER_BACKGROUND, 0, background, &view, bgPos.x, bgPos.y);
+                for (int i = 0; i < visibleCount; i++) {
+                    switch (visible[i]) {
+                        case DRAW_PLAYER:
+                            afficher_joueur(joueur, &renderQueue, &camera);
+                            break;
+                        case DRAW_ENEMY:
+                            animateEnemy(&enemy, &gameTimers);
+                            displayEnemy(&renderQueue, &enemy, &camera);
+                            break;
+                    }
+                }
+                LightingPass lightingPass = {&lightmap, &camera};
+                if (lighting) {
+                    Light torch = {joueur.position.x + joueur.position.w / 2, joueur.position.y + joueur.position.h / 2,
+                                   PLAYER_LIGHT_RADIUS, 255, 240, 200};
+                    lightmap_add_dynamic(&lightmap, torch);
+                    if (enemy.es_active && enemy.state != NEUTRALIZED) {
+                        Light glow = {enemy.es_position.x + enemy.es_position.w / 2, enemy.es_position.y + enemy.es_position.h / 2,
+                                      ES_LIGHT_RADIUS, 90, 200, 255};
+                        lightmap_add_dynamic(&lightmap, glow);
+                    }
+                    render_callback(&renderQueue, LAYER_LIGHTING, 0, dessiner_lumieres, &lightingPass);
+                }
                 
-                // Render game elements
-                SDL_BlitSurface(background, NULL, screen, &bgPos);
-                afficher_joueur(joueur, screen);
-                displayEnemy(screen, &enemy);
-                afficherminimap(mini, screen);
+                // Particles glow on top of the darkness
+                update_particles(frameTime);
+                render_callback(&renderQueue, LAYER_EFFECTS, 0, dessiner_particules, &camera);
+                
+                // Minimap and its markers: enemy and enigme triggers, drawn in one batch
+                MinimapPass minimapPass;
+                minimapPass.mini = &mini;
+                minimapPass.markerCount = 0;
+                if (enemy.state != NEUTRALIZED) {
+                    minimapPass.markerX[minimapPass.markerCount] = enemy.position.x + enemy.position.w / 2;
+                    minimapPass.markerY[minimapPass.markerCount] = enemy.position.y + enemy.position.h / 2;
+                    minimapPass.markerTypes[minimapPass.markerCount++] = MARKER_ENEMY;
+                }
+                minimapPass.markerX[minimapPass.markerCount] = enigme1_trigger_x;
+                minimapPass.markerY[minimapPass.markerCount] = enigme1_trigger_y;
+                minimapPass.markerTypes[minimapPass.markerCount++] = MARKER_ENIGME;
+                minimapPass.markerX[minimapPass.markerCount] = enigme2_trigger_x;
+                minimapPass.markerY[minimapPass.markerCount] = enigme2_trigger_y;
+                minimapPass.markerTypes[minimapPass.markerCount++] = MARKER_ENIGME;
+                render_callback(&renderQueue, LAYER_UI, 0, dessiner_minimap, &minimapPass);
                 
-                // Display player stats
-                display_stats(joueur, screen, font);
+                // Display player stats (HUD only re-renders values that changed)
+                gameTicks += frameTime;
+                timer_advance(&gameTimers, gameTicks);
+                hud_set_time(&hud, gameTicks / 1000);
+                display_stats(joueur, &renderQueue, &hud);
+                
+                // Draw the whole frame
+                render_flush(&renderQueue, screen);
                 
                 // Check enigme triggers
                 if (abs(joueur.position.x - enigme1_trigger_x) < trigger_range) {
@@ -250,20 +462,20 @@ int main(int argc, char *argv[]) {
                 }
                 
                 // Check collision between player and enemy
-                int collision_result = checkCollisionWithPlayer(&enemy, joueur.position);
-                if (collision_result) {
+                int collision_result = checkCollisionWithPlayer(&enemy, joueur.position,
+                                                                &joueur.frames[joueur.state][joueur.currentFrame],
+                                                                &joueur.masks[joueur.state][joueur.currentFrame]);
+                if (collision_result && !knockback.active) {
                     update_lives(&joueur, -1);
-                      // Push player away from enemy on collision
-                    if (joueur.position.x < enemy.position.x) {
-                        deplacer_joueur(&joueur, -30, -10, collision_mask);
-                    } else {
-                        deplacer_joueur(&joueur, 30, -10, collision_mask);
-                    }
+                    // Push player away from enemy over the next frames
+                    knockback.direction = joueur.position.x < enemy.position.x ? -1 : 1;
+                    knockback.active = sequencer_start(&sequences, sequence_knockback, &knockback, now);
                 }
                 
                 // Check game over condition
                 if (joueur.lives <= 0) {
                     gameState = STATE_GAMEOVER;
+                    sequencer_start(&sequences, sequence_game_over, &gameOver, now);
                 }
                 break;
                 
@@ -274,6 +486,7 @@ int main(int argc, char *argv[]) {
                     update_score(&joueur, 100);
                 }
                 gameState = STATE_MAIN_GAME;
+                lastFrame = SDL_GetTicks(); // Game time stood still during the enigme
                 break;
                   case STATE_ENIGME2:
                 // Call enigme2 function - play_enigme2 returns 1 for success, 0 for failure
@@ -282,10 +495,11 @@ int main(int argc, char *argv[]) {
                     update_score(&joueur, 200);
                 }
                 gameState = STATE_MAIN_GAME;
+                lastFrame = SDL_GetTicks(); // Game time stood still during the enigme
                 break;
                 
             case STATE_GAMEOVER:
-                // Display game over text
+                // Display game over text (lines revealed by sequence_game_over)
                 SDL_Surface *game_over;
                 SDL_Rect game_over_pos;
                 SDL_Color white = {255, 255, 255, 255};
@@ -297,35 +511,34 @@ int main(int argc, char *argv[]) {
                 game_over_pos.x = (SCREEN_WIDTH - game_over->w) / 2;
                 game_over_pos.y = (SCREEN_HEIGHT - game_over->h) / 2;
                 SDL_BlitSurface(game_over, NULL, screen, &game_over_pos);
+                int title_bottom = game_over_pos.y + game_over->h;
                 SDL_FreeSurface(game_over);
                 
                 // Display score
-                char score_text[50];
-                sprintf(score_text, "Final Score: %d", joueur.score);
-                SDL_Surface *score_surf = TTF_RenderText_Solid(font, score_text, white);                SDL_Rect score_pos = {
-                    (SCREEN_WIDTH - score_surf->w) / 2,
-                    game_over_pos.y + game_over->h + 20,
-                    0, 0
-                };
-                SDL_BlitSurface(score_surf, NULL, screen, &score_pos);
-                SDL_FreeSurface(score_surf);
-                
-                // Display instruction to return to menu
-                SDL_Surface *inst = TTF_RenderText_Solid(font, "Press ENTER to return to menu", white);                SDL_Rect inst_pos = {
-                    (SCREEN_WIDTH - inst->w) / 2,
-                    score_pos.y + 40,
-                    0, 0
-                };
-                SDL_BlitSurface(inst, NULL, screen, &inst_pos);
-                SDL_FreeSurface(inst);
-                
-                // Check for ENTER key to return to menu
-                if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_RETURN) {
-                    gameState = STATE_MENU;
-                    menuState = MAIN_MENU;
-                      // Reset player
-                    liberer_joueur(&joueur);
-                    initialiser_joueur(&joueur, "Player1", PLAYER_SPRITE_PATH);                }
+                if (gameOver.lines >= 2) {
+                    char score_text[50];
+                    sprintf(score_text, "Final Score: %d", joueur.score);
+                    SDL_Surface *score_surf = TTF_RenderText_Solid(font, score_text, white);
+                    SDL_Rect score_pos = {
+                        (SCREEN_WIDTH - score_surf->w) / 2,
+                        title_bottom + 20,
+                        0, 0
+                    };
+                    SDL_BlitSurface(score_surf, NULL, screen, &score_pos);
+                    SDL_FreeSurface(score_surf);
+                    
+                    // Display instruction to return to menu
+                    if (gameOver.lines >= 3) {
+                        SDL_Surface *inst = TTF_RenderText_Solid(font, "Press ENTER to return to menu", white);
+                        SDL_Rect inst_pos = {
+                            (SCREEN_WIDTH - inst->w) / 2,
+                            score_pos.y + 40,
+                            0, 0
+                        };
+                        SDL_BlitSurface(inst, NULL, screen, &inst_pos);
+                        SDL_FreeSurface(inst);
+                    }
+                }
                 break;
                 
             default:
@@ -344,6 +557,11 @@ int main(int argc, char *argv[]) {
 
     // Cleanup
     if (collision_mask) SDL_FreeSurface(collision_mask);
+    free_collision_map(&collisionMap);
+    free_ai_scheduler(&aiScheduler);
+    free_combat(&combat);
+    free_particles();
+    if (lighting) free_lightmap(&lightmap);
     
     cleanup_menu();
     
@@ -356,6 +574,7 @@ int main(int argc, char *argv[]) {
     freeEnemy(&enemy);
     free_minimap(&mini);
     free_surface_enigme(&en);
+    free_hud(&hud);
     
     cleanup_SDL();
 
@@ -384,6 +603,7 @@ int init_SDL() {
 
 // Clean up SDL subsystems
 void cleanup_SDL() {
+    free_atlas(); // Atlas views must all be freed by now
     Mix_CloseAudio();
     TTF_Quit();
     SDL_Quit();
@@ -396,3 +616,59 @@ SDL_Surface* load_image(const char* filename) {
 }
 
 // Note: display_stats function is defined in joueur.c
+
+// Knockback: push the player away over KNOCKBACK_FRAMES frames, then a grace period
+static int sequence_knockback(Sequence *seq) {
+    Knockback *k = seq->data;
+    SEQ_BEGIN(seq);
+    for (k->frame = 0; k->frame < KNOCKBACK_FRAMES; k->frame++) {
+        deplacer_joueur(k->joueur, k->direction * KNOCKBACK_DISTANCE / KNOCKBACK_FRAMES,
+                        k->frame == 0 ? -KNOCKBACK_LIFT : 0, k->map);
+        SEQ_YIELD(seq);
+    }
+    SEQ_WAIT(seq, KNOCKBACK_GRACE);
+    k->active = 0;
+    SEQ_END(seq);
+}
+
+// Game over: reveal the lines one by one, wait for ENTER, then reset the player
+static int sequence_game_over(Sequence *seq) {
+    GameOverScreen *g = seq->data;
+    SEQ_BEGIN(seq);
+    g->confirmed = 0;
+    for (g->lines = 1; g->lines < GAMEOVER_LINES; g->lines++) {
+        SEQ_WAIT(seq, GAMEOVER_LINE_DELAY);
+    }
+    SEQ_WAIT_UNTIL(seq, g->confirmed);
+    
+    *g->gameState = STATE_MENU;
+    *g->menuState = MAIN_MENU;
+    liberer_joueur(g->joueur);
+    initialiser_joueur(g->joueur, "Player1", PLAYER_SPRITE_PATH);
+    SEQ_END(seq);
+}
+
+// First solid row under x, or fallback without a collision map or ground there
+static int hauteur_sol(const CollisionMap *map, int x, int fallback) {
+    int row;
+    if (map && x >= 0 && x < map->w && collision_first_solid_row(map, x, x + 1, 0, map->h - 1, &row)) {
+        return row;
+    }
+    return fallback;
+}
+
+// Darkness overlay of the camera's view
+static void dessiner_lumieres(SDL_Surface *screen, void *data) {
+    LightingPass *pass = data;
+    lightmap_apply(pass->lightmap, screen, pass->camera);
+}
+
+static void dessiner_particules(SDL_Surface *screen, void *data) {
+    draw_particles(screen, data);
+}
+
+static void dessiner_minimap(SDL_Surface *screen, void *data) {
+    MinimapPass *pass = data;
+    afficherminimap(*pass->mini, screen);
+    afficher_marqueurs(pass->mini, screen, pass->markerX, pass->markerY, pass->markerTypes, pass->markerCount);
+}
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <SDL/SDL.h>
 #include <SDL/SDL_image.h>
 #include <SDL/SDL_mixer.h>
@@ -7,10 +8,32 @@
 #include "minimap.h"
 #include "assets.h"
 
-// Improve minimap initialization with proper error handling and scaling
-void initmap(minimap *m) {
-    // Load minimap background
-    m->backgroundMini = load_asset_image(TEXTURE_PATH "minibg.png");
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+static void init_brouillard(minimap *m);
+
+// Build the minimap from the level at load time (or minibg.png when there is no level)
+void initmap(minimap *m, SDL_Surface *level, SDL_Surface *mask) {
+    if (level) {
+        m->backgroundMini = genererminimap(level, mask);
+        m->worldW = level->w;
+        m->worldH = level->h;
+    } else {
+        m->backgroundMini = NULL;
+        m->worldW = SCREEN_WIDTH;
+        m->worldH = SCREEN_HEIGHT;
+    }
+    
+    if (!m->backgroundMini) {
+        // Load static minimap art
+        SDL_Surface *art = load_asset_image(TEXTURE_PATH "minibg.png");
+        if (art) {
+            m->backgroundMini = preblend_minimap(art);
+            SDL_FreeSurface(art);
+        }
+    }
     if (!m->backgroundMini) {
         printf("Failed to load minimap background: %s\n", IMG_GetError());
         // Create fallback background
@@ -38,18 +61,227 @@ void initmap(minimap *m) {
     m->posMiniJoueur.y = m->miniPos.y + m->backgroundMini->h / 2;
     m->posMiniJoueur.h = m->joueurMini->h;
     m->posMiniJoueur.w = m->joueurMini->w;
+    
+    // Shared by the player dot and the markers so both round the same way
+    m->scaleX = ((Uint32)m->backgroundMini->w << 16) / m->worldW;
+    m->scaleY = ((Uint32)m->backgroundMini->h << 16) / m->worldH;
+    
+    init_brouillard(m);
 }
 
-// Display minimap with proper blending and transparency
-void afficherminimap(minimap m, SDL_Surface *screen) {
-    // Set alpha blending for semi-transparent minimap
-    SDL_SetAlpha(m.backgroundMini, SDL_SRCALPHA, 180); // 180 = semi-transparent
+// Keep the full map aside and start with a fogged copy that is uncovered cell by cell
+static void init_brouillard(minimap *m) {
+    m->fullMini = m->backgroundMini;
+    m->cellsX = (m->fullMini->w + MINIMAP_CELL - 1) / MINIMAP_CELL;
+    m->cellsY = (m->fullMini->h + MINIMAP_CELL - 1) / MINIMAP_CELL;
+    m->revealed = calloc((m->cellsX * m->cellsY + 31) / 32, sizeof(Uint32));
+    m->lastCellX = -1;
+    m->lastCellY = -1;
+    
+    SDL_Surface *fog = SDL_ConvertSurface(m->fullMini, m->fullMini->format, m->fullMini->flags);
+    if (!fog || !m->revealed) {
+        // Not enough memory for the fog: show the whole map
+        printf("Minimap fog of war disabled\n");
+        if (fog) SDL_FreeSurface(fog);
+        free(m->revealed);
+        m->revealed = NULL;
+        m->fullMini = NULL;
+        return;
+    }
+    SDL_FillRect(fog, NULL, SDL_MapRGB(fog->format, MINIMAP_FOG, MINIMAP_FOG, MINIMAP_FOG));
+    m->backgroundMini = fog;
+}
+
+// Uncover the cells around (cx, cy): only cells never seen before are copied
+static void reveler_minimap(minimap *m, int cx, int cy) {
+    for (int y = cy - MINIMAP_REVEAL_RADIUS; y <= cy + MINIMAP_REVEAL_RADIUS; y++) {
+        if (y < 0 || y >= m->cellsY) continue;
+        for (int x = cx - MINIMAP_REVEAL_RADIUS; x <= cx + MINIMAP_REVEAL_RADIUS; x++) {
+            if (x < 0 || x >= m->cellsX) continue;
+            
+            int dx = x - cx, dy = y - cy;
+            if (dx * dx + dy * dy > MINIMAP_REVEAL_RADIUS * MINIMAP_REVEAL_RADIUS) continue;
+            
+            int bit = y * m->cellsX + x;
+            if (m->revealed[bit >> 5] & (1u << (bit & 31))) continue;
+            m->revealed[bit >> 5] |= 1u << (bit & 31);
+            
+            SDL_Rect cell = {x * MINIMAP_CELL, y * MINIMAP_CELL, MINIMAP_CELL, MINIMAP_CELL};
+            SDL_Rect dest = cell;
+            SDL_BlitSurface(m->fullMini, &cell, m->backgroundMini, &dest);
+        }
+    }
+}
+
+// Sum the source rows [y0, y1) into acc, one 32-bit counter per byte of the row
+static void accumuler_lignes(SDL_Surface *src, int y0, int y1, Uint32 *acc) {
+    int bytes = src->w * 4;
+    memset(acc, 0, bytes * sizeof(Uint32));
+    
+    for (int y = y0; y < y1; y++) {
+        const Uint8 *row = (const Uint8 *)src->pixels + y * src->pitch;
+        int i = 0;
+#ifdef __SSE2__
+        // 4 pixels per step: widen 16 bytes to 16 x 32-bit and add
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= bytes; i += 16) {
+            __m128i px = _mm_loadu_si128((const __m128i *)(row + i));
+            __m128i lo = _mm_unpacklo_epi8(px, zero);
+            __m128i hi = _mm_unpackhi_epi8(px, zero);
+            __m128i *a = (__m128i *)(acc + i);
+            _mm_storeu_si128(a + 0, _mm_add_epi32(_mm_loadu_si128(a + 0), _mm_unpacklo_epi16(lo, zero)));
+            _mm_storeu_si128(a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1), _mm_unpackhi_epi16(lo, zero)));
+            _mm_storeu_si128(a + 2, _mm_add_epi32(_mm_loadu_si128(a + 2), _mm_unpacklo_epi16(hi, zero)));
+            _mm_storeu_si128(a + 3, _mm_add_epi32(_mm_loadu_si128(a + 3), _mm_unpackhi_epi16(hi, zero)));
+        }
+#endif
+        for (; i < bytes; i++) {
+            acc[i] += row[i];
+        }
+    }
+}
+
+// Box filter downsampling between two 32bpp surfaces of the same format.
+// Every byte lane is averaged on its own, so the channel order does not matter.
+static void filtre_boite(SDL_Surface *src, SDL_Surface *dst) {
+    Uint32 *acc = malloc(src->w * 4 * sizeof(Uint32));
+    if (!acc) return;
+    
+    if (SDL_MUSTLOCK(src)) SDL_LockSurface(src);
+    if (SDL_MUSTLOCK(dst)) SDL_LockSurface(dst);
+    
+    for (int dy = 0; dy < dst->h; dy++) {
+        int y0 = dy * src->h / dst->h;
+        int y1 = (dy + 1) * src->h / dst->h;
+        if (y1 <= y0) y1 = y0 + 1;
+        accumuler_lignes(src, y0, y1, acc);
+        
+        Uint8 *out = (Uint8 *)dst->pixels + dy * dst->pitch;
+        for (int dx = 0; dx < dst->w; dx++) {
+            int x0 = dx * src->w / dst->w;
+            int x1 = (dx + 1) * src->w / dst->w;
+            if (x1 <= x0) x1 = x0 + 1;
+            Uint32 area = (x1 - x0) * (y1 - y0);
+            Uint32 sum[4];
+#ifdef __SSE2__
+            // One pixel (4 byte lanes) per vector
+            __m128i total = _mm_setzero_si128();
+            for (int x = x0; x < x1; x++) {
+                total = _mm_add_epi32(total, _mm_loadu_si128((const __m128i *)(acc + x * 4)));
+            }
+            _mm_storeu_si128((__m128i *)sum, total);
+#else
+            sum[0] = sum[1] = sum[2] = sum[3] = 0;
+            for (int x = x0; x < x1; x++) {
+                for (int c = 0; c < 4; c++) sum[c] += acc[x * 4 + c];
+            }
+#endif
+            for (int c = 0; c < 4; c++) {
+                out[dx * 4 + c] = (sum[c] + area / 2) / area;
+            }
+        }
+    }
+    
+    if (SDL_MUSTLOCK(dst)) SDL_UnlockSurface(dst);
+    if (SDL_MUSTLOCK(src)) SDL_UnlockSurface(src);
+    free(acc);
+}
+
+// Downsample a whole surface into a new w x h 32bpp surface
+static SDL_Surface *reduire_surface(SDL_Surface *src, int w, int h) {
+    SDL_Surface *dst = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+    if (!dst) return NULL;
+    
+    // Work on a 32bpp copy in the same format as dst, alpha copied rather than blended
+    SDL_Surface *src32 = SDL_ConvertSurface(src, dst->format, SDL_SWSURFACE);
+    if (!src32) {
+        SDL_FreeSurface(dst);
+        return NULL;
+    }
+    
+    filtre_boite(src32, dst);
+    SDL_FreeSurface(src32);
+    return dst;
+}
+
+// Downsample the level background and collision mask into the minimap, once at load
+SDL_Surface *genererminimap(SDL_Surface *level, SDL_Surface *mask) {
+    // Keep the level's aspect ratio within MINIMAP_WIDTH x MINIMAP_MAX_HEIGHT
+    int w = MINIMAP_WIDTH;
+    int h = level->h * MINIMAP_WIDTH / level->w;
+    if (h > MINIMAP_MAX_HEIGHT) {
+        h = MINIMAP_MAX_HEIGHT;
+        w = level->w * MINIMAP_MAX_HEIGHT / level->h;
+    }
+    if (w < 1) w = 1;
+    if (h < 1) h = 1;
+    
+    SDL_Surface *mini = reduire_surface(level, w, h);
+    if (!mini) {
+        printf("Failed to generate minimap: %s\n", SDL_GetError());
+        return NULL;
+    }
+    SDL_Surface *walls = mask ? reduire_surface(mask, w, h) : NULL;
     
-    // Blit minimap background
+    // Dim the scenery, draw walls by their coverage, and pre-blend the translucency
+    // over a black panel so the per-frame blit is a plain opaque copy
+    if (SDL_MUSTLOCK(mini)) SDL_LockSurface(mini);
+    for (int y = 0; y < h; y++) {
+        Uint32 *row = (Uint32 *)((Uint8 *)mini->pixels + y * mini->pitch);
+        Uint32 *wallRow = walls ? (Uint32 *)((Uint8 *)walls->pixels + y * walls->pitch) : NULL;
+        
+        for (int x = 0; x < w; x++) {
+            Uint8 r, g, b;
+            SDL_GetRGB(row[x], mini->format, &r, &g, &b);
+            int cr = r * 6 / 10, cg = g * 6 / 10, cb = b * 6 / 10;
+            
+            if (wallRow) {
+                Uint8 wr, wg, wb;
+                SDL_GetRGB(wallRow[x], walls->format, &wr, &wg, &wb);
+                int coverage = wr > wg ? (wr > wb ? wr : wb) : (wg > wb ? wg : wb); // Non-black = solid
+                cr += (230 - cr) * coverage / 255;
+                cg += (230 - cg) * coverage / 255;
+                cb += (230 - cb) * coverage / 255;
+            }
+            
+            row[x] = SDL_MapRGB(mini->format, cr * MINIMAP_ALPHA / 255, cg * MINIMAP_ALPHA / 255,
+                                cb * MINIMAP_ALPHA / 255);
+        }
+    }
+    if (SDL_MUSTLOCK(mini)) SDL_UnlockSurface(mini);
+    if (walls) SDL_FreeSurface(walls);
+    
+    SDL_Surface *optimized = SDL_DisplayFormat(mini);
+    if (optimized) {
+        SDL_FreeSurface(mini);
+        return optimized;
+    }
+    return mini;
+}
+
+// Blend hand-made minimap art over a black panel once, instead of alpha-blitting every frame
+SDL_Surface *preblend_minimap(SDL_Surface *art) {
+    SDL_Surface *panel = SDL_CreateRGBSurface(SDL_SWSURFACE, art->w, art->h, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+    if (!panel) return NULL;
+    
+    SDL_FillRect(panel, NULL, SDL_MapRGB(panel->format, 0, 0, 0));
+    SDL_SetAlpha(art, SDL_SRCALPHA, MINIMAP_ALPHA);
+    SDL_BlitSurface(art, NULL, panel, NULL);
+    
+    SDL_Surface *optimized = SDL_DisplayFormat(panel);
+    if (optimized) {
+        SDL_FreeSurface(panel);
+        return optimized;
+    }
+    return panel;
+}
+
+// Display minimap: the background is pre-blended, only markers change every frame
+void afficherminimap(minimap m, SDL_Surface *screen) {
+    // Blit minimap background (opaque copy)
     SDL_BlitSurface(m.backgroundMini, NULL, screen, &m.miniPos);
     
-    // Blit player indicator (full opacity)
-    SDL_SetAlpha(m.joueurMini, SDL_SRCALPHA, 255); // 255 = fully opaque
+    // Blit player indicator
     SDL_BlitSurface(m.joueurMini, NULL, screen, &m.posMiniJoueur);
     
     // Draw a border around the minimap
@@ -95,23 +327,46 @@ void free_minimap(minimap *m) {
         SDL_FreeSurface(m->joueurMini);
         m->joueurMini = NULL;
     }
+    
+    if (m->fullMini) {
+        SDL_FreeSurface(m->fullMini);
+        m->fullMini = NULL;
+    }
+    free(m->revealed);
+    m->revealed = NULL;
+}
+
+// World coordinate -> minimap-local coordinate. Positions outside the level give -1, so
+// their markers are culled, and the 64-bit product stays far below overflow.
+static int vers_minimap(int v, int world, Uint32 scale) {
+    if (v < 0 || v >= world) return -1;
+    return (int)(((Uint64)v * scale) >> 16);
+}
+
+// Clamp a world coordinate into the level
+static int sur_niveau(int v, int world) {
+    return v < 0 ? 0 : v >= world ? world - 1 : v;
 }
 
 // Update minimap to correctly track player position
-void MAJMinimap(SDL_Rect posJoueur, minimap *m, SDL_Rect camera, float redimensionnement) {
-    // Calculate scaling factors between game world and minimap
-    // These scale factors convert game world coordinates to minimap coordinates
-    float scaleX = (float)m->backgroundMini->w / SCREEN_WIDTH;
-    float scaleY = (float)m->backgroundMini->h / SCREEN_HEIGHT;
-    
-    // Calculate new player position on minimap
-    // Add camera offset to make the minimap show the visible area
-    int miniX = m->miniPos.x + (posJoueur.x - camera.x) * scaleX;
-    int miniY = m->miniPos.y + (posJoueur.y - camera.y) * scaleY;
+void MAJMinimap(WorldRect posJoueur, minimap *m) {
+    // The minimap covers the whole level: world coordinates scale directly to it,
+    // with the 16.16 scale the markers use (the player is kept inside the level first)
+    int localX = vers_minimap(sur_niveau(posJoueur.x + posJoueur.w / 2, m->worldW), m->worldW, m->scaleX);
+    int localY = vers_minimap(sur_niveau(posJoueur.y + posJoueur.h / 2, m->worldH), m->worldH, m->scaleY);
+    int miniX = m->miniPos.x + vers_minimap(sur_niveau(posJoueur.x, m->worldW), m->worldW, m->scaleX);
+    int miniY = m->miniPos.y + vers_minimap(sur_niveau(posJoueur.y, m->worldH), m->worldH, m->scaleY);
     
-    // Apply redimensionnement factor if needed
-    miniX = (int)(miniX / redimensionnement);
-    miniY = (int)(miniY / redimensionnement);
+    // Fog of war: reveal only when the player enters another cell
+    if (m->revealed) {
+        int cx = localX / MINIMAP_CELL;
+        int cy = localY / MINIMAP_CELL;
+        if (cx != m->lastCellX || cy != m->lastCellY) {
+            reveler_minimap(m, cx, cy);
+            m->lastCellX = cx;
+            m->lastCellY = cy;
+        }
+    }
     
     // Ensure player indicator stays within minimap bounds
     if (miniX < m->miniPos.x) miniX = m->miniPos.x;
@@ -126,6 +381,96 @@ void MAJMinimap(SDL_Rect posJoueur, minimap *m, SDL_Rect camera, float redimensi
     m->posMiniJoueur.y = miniY;
 }
 
+// Marker colors, indexed by MarkerType
+static const Uint8 marker_colors[MARKER_TYPES][3] = {
+    {255, 60, 60},   // MARKER_ENEMY
+    {255, 220, 0},   // MARKER_ITEM
+    {80, 160, 255}   // MARKER_ENIGME
+};
+
+// World positions -> minimap-local positions in one pass, with the same 16.16 scale
+// as MAJMinimap so markers and the player dot round the same way
+static void transformer_marqueurs(const minimap *m, const int *worldX, const int *worldY, int count, int *outX, int *outY) {
+    int i = 0;
+#ifdef __SSE2__
+    // 4 markers per step: _mm_mul_epu32 multiplies the even lanes into 64 bits, so the
+    // odd lanes are shifted down for a second product. Lanes outside the level are
+    // zeroed before the product and set to -1 after, like vers_minimap.
+    const __m128i ones = _mm_set1_epi32(-1);
+    const __m128i limitX = _mm_set1_epi32(m->worldW), limitY = _mm_set1_epi32(m->worldH);
+    const __m128i scaleX = _mm_set1_epi32(m->scaleX), scaleY = _mm_set1_epi32(m->scaleY);
+    for (; i + 4 <= count; i += 4) {
+        for (int axis = 0; axis < 2; axis++) {
+            const int *in = axis ? worldY : worldX;
+            __m128i limit = axis ? limitY : limitX, scale = axis ? scaleY : scaleX;
+            __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+            __m128i inside = _mm_and_si128(_mm_cmpgt_epi32(v, ones), _mm_cmpgt_epi32(limit, v));
+            v = _mm_and_si128(v, inside);
+            // Products stay below 2^32 inside the level: the halves just need merging
+            __m128i even = _mm_srli_epi64(_mm_mul_epu32(v, scale), 16);
+            __m128i odd = _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(v, 32), scale), 16);
+            __m128i local = _mm_or_si128(even, _mm_slli_epi64(odd, 32));
+            local = _mm_or_si128(local, _mm_andnot_si128(inside, ones));
+            _mm_storeu_si128((__m128i *)((axis ? outY : outX) + i), local);
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        outX[i] = vers_minimap(worldX[i], m->worldW, m->scaleX);
+        outY[i] = vers_minimap(worldY[i], m->worldH, m->scaleY);
+    }
+}
+
+// Draw every marker with one lock of the screen, culling those outside the minimap.
+// Positions are transformed MINIMAP_MAX_MARKERS at a time.
+void afficher_marqueurs(minimap *m, SDL_Surface *screen, const int *worldX, const int *worldY, const Uint8 *types, int count) {
+    int localX[MINIMAP_MAX_MARKERS], localY[MINIMAP_MAX_MARKERS];
+    Uint32 colors[MARKER_TYPES];
+    
+    if (count <= 0) return;
+    
+    for (int t = 0; t < MARKER_TYPES; t++) {
+        colors[t] = SDL_MapRGB(screen->format, marker_colors[t][0], marker_colors[t][1], marker_colors[t][2]);
+    }
+    
+    // Marker centered on its position, fully inside the minimap
+    int maxX = m->backgroundMini->w - MINIMAP_MARKER_SIZE;
+    int maxY = m->backgroundMini->h - MINIMAP_MARKER_SIZE;
+    
+    // Other depths: let SDL fill each marker
+    int direct = screen->format->BytesPerPixel == 4;
+    Uint8 *origin = NULL;
+    if (direct) {
+        if (SDL_MUSTLOCK(screen)) SDL_LockSurface(screen);
+        origin = (Uint8 *)screen->pixels + m->miniPos.y * screen->pitch + m->miniPos.x * 4;
+    }
+    
+    for (int first = 0; first < count; first += MINIMAP_MAX_MARKERS) {
+        int batch = count - first < MINIMAP_MAX_MARKERS ? count - first : MINIMAP_MAX_MARKERS;
+        const Uint8 *batchTypes = types + first;
+        transformer_marqueurs(m, worldX + first, worldY + first, batch, localX, localY);
+        
+        for (int i = 0; i < batch; i++) {
+            int x = localX[i] - MINIMAP_MARKER_SIZE / 2, y = localY[i] - MINIMAP_MARKER_SIZE / 2;
+            if (x < 0 || y < 0 || x > maxX || y > maxY || batchTypes[i] >= MARKER_TYPES) continue;
+            
+            Uint32 color = colors[batchTypes[i]];
+            if (!direct) {
+                SDL_Rect r = {m->miniPos.x + x, m->miniPos.y + y, MINIMAP_MARKER_SIZE, MINIMAP_MARKER_SIZE};
+                SDL_FillRect(screen, &r, color);
+                continue;
+            }
+            Uint8 *row = origin + y * screen->pitch + x * 4;
+            for (int dy = 0; dy < MINIMAP_MARKER_SIZE; dy++, row += screen->pitch) {
+                Uint32 *p = (Uint32 *)row;
+                for (int dx = 0; dx < MINIMAP_MARKER_SIZE; dx++) p[dx] = color;
+            }
+        }
+    }
+    
+    if (direct && SDL_MUSTLOCK(screen)) SDL_UnlockSurface(screen);
+}
+
 SDL_Color GetPixel(SDL_Surface *Background, int x, int y)
 {
 SDL_Color color;
@@ -1,5 +1,29 @@
 #ifndef MINIMAP_H_INCLUDED
 #define MINIMAP_H_INCLUDED
+
+#include "camera.h"
+
+// Generated minimap size and translucency
+#define MINIMAP_WIDTH 200
+#define MINIMAP_MAX_HEIGHT 150
+#define MINIMAP_ALPHA 180
+
+// Fog of war: minimap pixels per cell, cells uncovered around the player, fog gray level
+#define MINIMAP_CELL 8
+#define MINIMAP_REVEAL_RADIUS 3
+#define MINIMAP_FOG 20
+
+// Markers drawn over the minimap (enemies, items, enigme triggers...)
+#define MINIMAP_MARKER_SIZE 3
+#define MINIMAP_MAX_MARKERS 256 // Markers transformed per batch (any count can be drawn)
+
+typedef enum {
+    MARKER_ENEMY,
+    MARKER_ITEM,
+    MARKER_ENIGME,
+    MARKER_TYPES
+} MarkerType;
+
 typedef struct
 {
 SDL_Rect position_perso;
@@ -11,11 +35,20 @@ SDL_Rect miniPos; // Position of the minimap on screen
 SDL_Surface *backgroundMini; // Minimap background surface
 SDL_Surface *joueurMini; // Player representation on minimap
 SDL_Rect posMiniJoueur; // Position of player on minimap
+int worldW, worldH; // Level size covered by the minimap
+Uint32 scaleX, scaleY; // World -> minimap scale per axis, 16.16 fixed point
+SDL_Surface *fullMini; // Fully revealed map (NULL if fog of war is disabled)
+Uint32 *revealed; // One bit per cell already uncovered on backgroundMini
+int cellsX, cellsY; // Fog grid size
+int lastCellX, lastCellY; // Player cell at the last reveal
 }minimap;
-void initmap( minimap *m);
+void initmap( minimap *m, SDL_Surface *level, SDL_Surface *mask);
+SDL_Surface *genererminimap(SDL_Surface *level, SDL_Surface *mask); // Box-filtered level thumbnail
+SDL_Surface *preblend_minimap(SDL_Surface *art);
 void afficherminimap (minimap m, SDL_Surface * screen);
 void free_minimap (minimap *m);
-void MAJMinimap(SDL_Rect posJoueur, minimap * m, SDL_Rect camera, float redimensionnement); // Update player position on minimap
+void MAJMinimap(WorldRect posJoueur, minimap * m); // Update player position on minimap
+void afficher_marqueurs(minimap *m, SDL_Surface *screen, const int *worldX, const int *worldY, const Uint8 *types, int count); // All markers in one pass
 void update_1_(SDL_Rect *prochain , SDL_Rect *principal, SDL_Rect *Pminimap, int distance, int longueur,int longueurM);
 void update_2_(SDL_Rect *prochain , SDL_Rect *principal, SDL_Rect *Pminimap, int distance, int longueur,int longueurM);
 void mouvement(Personne *p ,Personne *pM ,Personne *pMprochaine, int distance, int longueur,int longueurM , SDL_Surface *masked , int sens);
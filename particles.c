@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "particles.h"
+#include "fixedpoint.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Structure of arrays, allocated with the capacity rounded up to 4 so the update
+// can always work on whole groups of 4
+static float *part_x = NULL;
+static float *part_y = NULL;
+static float *part_vx = NULL;
+static float *part_vy = NULL;
+static float *part_life = NULL;         // Milliseconds left
+static float *part_inv_life = NULL;     // 1 / starting life, for the fade
+static Uint32 *part_color = NULL;       // 0xRRGGBB
+static int part_count = 0;
+static int part_capacity = 0;
+
+int init_particles(int capacity) {
+    free_particles();
+    
+    int padded = (capacity + 3) & ~3;
+    part_x = calloc(padded, sizeof(float));
+    part_y = calloc(padded, sizeof(float));
+    part_vx = calloc(padded, sizeof(float));
+    part_vy = calloc(padded, sizeof(float));
+    part_life = calloc(padded, sizeof(float));
+    part_inv_life = calloc(padded, sizeof(float));
+    part_color = calloc(padded, sizeof(Uint32));
+    if (!part_x || !part_y || !part_vx || !part_vy || !part_life || !part_inv_life || !part_color) {
+        printf("Out of memory for %d particles\n", capacity);
+        free_particles();
+        return 0;
+    }
+    
+    part_capacity = capacity;
+    part_count = 0;
+    return 1;
+}
+
+void free_particles() {
+    free(part_x);
+    free(part_y);
+    free(part_vx);
+    free(part_vy);
+    free(part_life);
+    free(part_inv_life);
+    free(part_color);
+    part_x = part_y = part_vx = part_vy = part_life = part_inv_life = NULL;
+    part_color = NULL;
+    part_count = 0;
+    part_capacity = 0;
+}
+
+void clear_particles() {
+    part_count = 0;
+}
+
+int particle_count() {
+    return part_count;
+}
+
+void emit_particles(int x, int y, int count, int speed, Uint32 rgb, Uint32 lifeMs) {
+    if (lifeMs == 0) return;
+    
+    for (int n = 0; n < count && part_count < part_capacity; n++) {
+        int i = part_count++;
+        int angle = rand() % FIX_ANGLE_STEPS;
+        float v = (float)speed * (0.25f + 0.75f * (float)rand() / RAND_MAX);
+        part_x[i] = (float)x;
+        part_y[i] = (float)y;
+        part_vx[i] = v * fix_cos(angle) / FIX_ONE;
+        part_vy[i] = v * fix_sin(angle) / FIX_ONE;
+        part_life[i] = (float)lifeMs * (0.5f + 0.5f * (float)rand() / RAND_MAX);
+        part_inv_life[i] = 1.0f / part_life[i];
+        part_color[i] = rgb;
+    }
+}
+
+void update_particles(Uint32 ms) {
+    if (part_count == 0) return;
+    
+    float dt = ms / 1000.0f;
+    float gdt = PARTICLE_GRAVITY * dt;
+    float dms = (float)ms;
+    int i = 0;
+    
+#ifdef __SSE2__
+    // Integrate 4 particles at a time; the padding past part_count is harmless
+    __m128 vdt = _mm_set1_ps(dt);
+    __m128 vgdt = _mm_set1_ps(gdt);
+    __m128 vdms = _mm_set1_ps(dms);
+    for (; i < part_count; i += 4) {
+        __m128 vy = _mm_loadu_ps(part_vy + i);
+        _mm_storeu_ps(part_x + i, _mm_add_ps(_mm_loadu_ps(part_x + i), _mm_mul_ps(_mm_loadu_ps(part_vx + i), vdt)));
+        _mm_storeu_ps(part_y + i, _mm_add_ps(_mm_loadu_ps(part_y + i), _mm_mul_ps(vy, vdt)));
+        _mm_storeu_ps(part_vy + i, _mm_add_ps(vy, vgdt));
+        _mm_storeu_ps(part_life + i, _mm_sub_ps(_mm_loadu_ps(part_life + i), vdms));
+    }
+#else
+    for (; i < part_count; i++) {
+        part_x[i] += part_vx[i] * dt;
+        part_y[i] += part_vy[i] * dt;
+        part_vy[i] += gdt;
+        part_life[i] -= dms;
+    }
+#endif
+    
+    // Remove the dead ones, the last particle takes their place
+    i = 0;
+    while (i < part_count) {
+        if (part_life[i] > 0.0f) {
+            i++;
+            continue;
+        }
+        int last = --part_count;
+        part_x[i] = part_x[last];
+        part_y[i] = part_y[last];
+        part_vx[i] = part_vx[last];
+        part_vy[i] = part_vy[last];
+        part_life[i] = part_life[last];
+        part_inv_life[i] = part_inv_life[last];
+        part_color[i] = part_color[last];
+    }
+}
+
+// Saturating add of two 32-bit pixels, byte by byte
+static Uint32 ajouter_sature(Uint32 a, Uint32 b) {
+#ifdef __SSE2__
+    return (Uint32)_mm_cvtsi128_si32(_mm_adds_epu8(_mm_cvtsi32_si128((int)a), _mm_cvtsi32_si128((int)b)));
+#else
+    Uint32 out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        Uint32 sum = ((a >> shift) & 0xFF) + ((b >> shift) & 0xFF);
+        out |= (sum > 255 ? 255 : sum) << shift;
+    }
+    return out;
+#endif
+}
+
+void draw_particles(SDL_Surface *screen, const Camera *camera) {
+    if (part_count == 0) return;
+    
+    // 32-bit surfaces with 8-bit channels only (the game screen)
+    SDL_PixelFormat *fmt = screen->format;
+    if (fmt->BytesPerPixel != 4 || fmt->Rloss || fmt->Gloss || fmt->Bloss) return;
+    
+    if (SDL_MUSTLOCK(screen) && SDL_LockSurface(screen) < 0) return;
+    
+    int pitch = screen->pitch / 4;
+    Uint32 *pixels = (Uint32 *)screen->pixels;
+    int maxX = screen->w - PARTICLE_SIZE;
+    int maxY = screen->h - PARTICLE_SIZE;
+    for (int i = 0; i < part_count; i++) {
+        int sx = (int)part_x[i] - camera->x;
+        int sy = (int)part_y[i] - camera->y;
+        if (sx < 0 || sy < 0 || sx > maxX || sy > maxY) continue;
+        
+        // Fade with the life left: scale the color, then add it
+        int k = (int)(part_life[i] * part_inv_life[i] * 256.0f);
+        Uint32 rgb = part_color[i];
+        Uint32 add = ((((rgb >> 16) & 0xFF) * k >> 8) << fmt->Rshift) |
+                     ((((rgb >> 8) & 0xFF) * k >> 8) << fmt->Gshift) |
+                     (((rgb & 0xFF) * k >> 8) << fmt->Bshift);
+        
+        Uint32 *p = pixels + sy * pitch + sx;
+        for (int dy = 0; dy < PARTICLE_SIZE; dy++, p += pitch) {
+            for (int dx = 0; dx < PARTICLE_SIZE; dx++) {
+                p[dx] = ajouter_sature(p[dx], add);
+            }
+        }
+    }
+    
+    if (SDL_MUSTLOCK(screen)) SDL_UnlockSurface(screen);
+}
@@ -0,0 +1,32 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <SDL/SDL.h>
+#include "camera.h"
+
+// Particle effects (hit sparks, landing dust, deaths...). One shared set of particles,
+// stored as structure of arrays so the update runs 4 particles per SSE2 instruction.
+#define PARTICLE_CAPACITY 32768
+#define PARTICLE_GRAVITY 600.0f   // Pixels per second squared
+#define PARTICLE_SIZE 2           // Splat size in pixels
+
+// Colors
+#define PARTICLE_SPARK 0xFFD040
+#define PARTICLE_DUST 0x806850
+#define PARTICLE_DEATH 0xFF3020
+#define PARTICLE_SUCCESS 0x60FF80
+
+// Allocate the buffers (call once); without it emitting does nothing
+int init_particles(int capacity);
+void free_particles();
+void clear_particles();
+
+// count particles from (x, y) in random directions, up to speed pixels per second,
+// fading out over lifeMs. rgb is 0xRRGGBB.
+void emit_particles(int x, int y, int count, int speed, Uint32 rgb, Uint32 lifeMs);
+
+void update_particles(Uint32 ms);
+void draw_particles(SDL_Surface *screen, const Camera *camera); // Additive, in one pass
+int particle_count();
+
+#endif // PARTICLES_H
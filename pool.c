@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pool.h"
+
+#define HANDLE_SLOT(h) ((int)((h) & 0xFFFF))
+#define HANDLE_GENERATION(h) ((Uint16)((h) >> 16))
+#define MAKE_HANDLE(slot, gen) (((PoolHandle)(gen) << 16) | (PoolHandle)(slot))
+
+// Every slot free, chained in order
+static void vider_pool(Pool *pool) {
+    for (int s = 0; s < pool->capacity; s++) {
+        pool->index[s] = s + 1 < pool->capacity ? s + 1 : -1;
+    }
+    pool->freeSlot = pool->capacity > 0 ? 0 : -1;
+    pool->count = 0;
+}
+
+int init_pool(Pool *pool, int itemSize, int capacity) {
+    if (capacity > POOL_MAX_CAPACITY) {
+        printf("Pool capacity %d reduced to %d\n", capacity, POOL_MAX_CAPACITY);
+        capacity = POOL_MAX_CAPACITY;
+    }
+    
+    pool->itemSize = itemSize;
+    pool->capacity = capacity;
+    pool->items = malloc((size_t)capacity * itemSize);
+    pool->generation = malloc(capacity * sizeof(Uint16));
+    pool->index = malloc(capacity * sizeof(int));
+    pool->slot = malloc(capacity * sizeof(int));
+    if (!pool->items || !pool->generation || !pool->index || !pool->slot) {
+        printf("Out of memory for a pool of %d objects\n", capacity);
+        free_pool(pool);
+        return 0;
+    }
+    
+    for (int s = 0; s < capacity; s++) {
+        pool->generation[s] = 1; // Keeps handle 0 invalid
+    }
+    vider_pool(pool);
+    return 1;
+}
+
+void free_pool(Pool *pool) {
+    free(pool->items);
+    free(pool->generation);
+    free(pool->index);
+    free(pool->slot);
+    pool->items = NULL;
+    pool->generation = NULL;
+    pool->index = NULL;
+    pool->slot = NULL;
+    pool->capacity = 0;
+    pool->count = 0;
+    pool->freeSlot = -1;
+}
+
+void *pool_alloc(Pool *pool, PoolHandle *handle) {
+    int s = pool->freeSlot;
+    if (s < 0) return NULL;
+    
+    pool->freeSlot = pool->index[s];
+    int i = pool->count++;
+    pool->index[s] = i;
+    pool->slot[i] = s;
+    if (handle) *handle = MAKE_HANDLE(s, pool->generation[s]);
+    return (char *)pool->items + (size_t)i * pool->itemSize;
+}
+
+// Position in items of a live handle, -1 if stale
+static int position_handle(const Pool *pool, PoolHandle handle) {
+    int s = HANDLE_SLOT(handle);
+    if (s >= pool->capacity || pool->generation[s] != HANDLE_GENERATION(handle)) return -1;
+    return pool->index[s];
+}
+
+void *pool_get(const Pool *pool, PoolHandle handle) {
+    int i = position_handle(pool, handle);
+    return i < 0 ? NULL : (char *)pool->items + (size_t)i * pool->itemSize;
+}
+
+void pool_release(Pool *pool, PoolHandle handle) {
+    int i = position_handle(pool, handle);
+    if (i >= 0) pool_release_at(pool, i);
+}
+
+void pool_release_at(Pool *pool, int i) {
+    int s = pool->slot[i];
+    int last = --pool->count;
+    
+    // Keep the live objects packed
+    if (i != last) {
+        memcpy((char *)pool->items + (size_t)i * pool->itemSize,
+               (char *)pool->items + (size_t)last * pool->itemSize, pool->itemSize);
+        pool->slot[i] = pool->slot[last];
+        pool->index[pool->slot[i]] = i;
+    }
+    
+    // Stale handles from now on (generation 0 is skipped so handle 0 stays invalid)
+    if (++pool->generation[s] == 0) pool->generation[s] = 1;
+    pool->index[s] = pool->freeSlot;
+    pool->freeSlot = s;
+}
+
+PoolHandle pool_handle_at(const Pool *pool, int i) {
+    int s = pool->slot[i];
+    return MAKE_HANDLE(s, pool->generation[s]);
+}
+
+void pool_clear(Pool *pool) {
+    for (int i = 0; i < pool->count; i++) {
+        int s = pool->slot[i];
+        if (++pool->generation[s] == 0) pool->generation[s] = 1;
+    }
+    vider_pool(pool);
+}
@@ -0,0 +1,39 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <SDL/SDL.h>
+
+// Fixed-capacity pool for transient objects (hitboxes, projectiles, particles...).
+// Live objects stay packed at the start of items so they can be iterated as a plain
+// array; releasing one moves the last object into its place. Objects are referred to
+// by generational handles, which go stale (pool_get returns NULL) once released.
+#define POOL_MAX_CAPACITY 65535
+
+typedef Uint32 PoolHandle;        // Slot in the low 16 bits, generation in the high 16; 0 is never valid
+#define POOL_NO_HANDLE 0
+
+typedef struct {
+    void *items;                  // count live objects of itemSize bytes, packed
+    int itemSize;
+    int capacity;
+    int count;
+    Uint16 *generation;           // Per slot, bumped on release
+    int *index;                   // Per slot: position in items while live, next free slot otherwise
+    int *slot;                    // Per position in items: its slot
+    int freeSlot;                 // Head of the free slot list, -1 if full
+} Pool;
+
+// Typed view of the packed objects: POOL_ITEMS(&pool, Hitbox)[i] for i < pool.count
+#define POOL_ITEMS(pool, type) ((type *)(pool)->items)
+
+int init_pool(Pool *pool, int itemSize, int capacity); // Returns 0 if out of memory
+void free_pool(Pool *pool);
+
+void *pool_alloc(Pool *pool, PoolHandle *handle);      // Uninitialized object, NULL if full. O(1)
+void *pool_get(const Pool *pool, PoolHandle handle);   // NULL if the handle is stale
+void pool_release(Pool *pool, PoolHandle handle);      // O(1), ignores stale handles
+void pool_release_at(Pool *pool, int i);               // Release items[i]; items[count - 1] moves there
+PoolHandle pool_handle_at(const Pool *pool, int i);    // Handle of items[i]
+void pool_clear(Pool *pool);                           // Release everything, all handles go stale
+
+#endif // POOL_H
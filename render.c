@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <string.h>
+#include "render.h"
+
+void init_render_queue(RenderQueue *queue, const SDL_PixelFormat *format) {
+    queue->format = format;
+    queue->count = 0;
+    queue->surfaceCount = 0;
+    memset(queue->layerDraws, 0, sizeof(queue->layerDraws));
+    queue->surfaceSwitches = 0;
+    queue->dropped = 0;
+}
+
+// Small id of a source surface for the sort key, 0 for none
+static Uint32 id_surface(RenderQueue *queue, SDL_Surface *surface) {
+    if (!surface) return 0;
+    
+    // Few distinct sources per frame, and consecutive submits often share one
+    for (int i = queue->surfaceCount - 1; i >= 0; i--) {
+        if (queue->surfaces[i] == surface) return i + 1;
+    }
+    if (queue->surfaceCount == RENDER_MAX_SURFACES) return RENDER_MAX_SURFACES + 1;
+    queue->surfaces[queue->surfaceCount++] = surface;
+    return queue->surfaceCount;
+}
+
+// Key: layer (8 bits) | depth (16 bits) | surface id (8 bits)
+static RenderCommand* ajouter_commande(RenderQueue *queue, RenderLayer layer, int depth, SDL_Surface *surface) {
+    if (queue->count == RENDER_MAX_COMMANDS) {
+        queue->dropped++;
+        return NULL;
+    }
+    
+    if (depth < -32768) depth = -32768;
+    if (depth > 32767) depth = 32767;
+    int i = queue->count++;
+    queue->keys[0][i] = (Uint32)layer << 24 | (Uint32)(depth + 32768) << 8 | id_surface(queue, surface);
+    queue->order[0][i] = (Uint16)i;
+    
+    RenderCommand *cmd = &queue->commands[i];
+    cmd->surface = surface;
+    cmd->draw = NULL;
+    cmd->data = NULL;
+    return cmd;
+}
+
+int render_blit(RenderQueue *queue, RenderLayer layer, int depth, SDL_Surface *surface, const SDL_Rect *src, int x, int y) {
+    if (!surface) return 1;
+    
+    RenderCommand *cmd = ajouter_commande(queue, layer, depth, surface);
+    if (!cmd) return 0;
+    if (src) {
+        cmd->src = *src;
+    } else {
+        SDL_Rect all = {0, 0, surface->w, surface->h};
+        cmd->src = all;
+    }
+    cmd->x = x;
+    cmd->y = y;
+    return 1;
+}
+
+int render_sprite(RenderQueue *queue, RenderLayer layer, int depth, SDL_Surface *image, const SpriteFrame *frame, int x, int y) {
+    if (frame->src.w == 0 || frame->src.h == 0) return 1;
+    return render_blit(queue, layer, depth, image, &frame->src, x + frame->offset_x, y + frame->offset_y);
+}
+
+int render_callback(RenderQueue *queue, RenderLayer layer, int depth, RenderCallback draw, void *data) {
+    RenderCommand *cmd = ajouter_commande(queue, layer, depth, NULL);
+    if (!cmd) return 0;
+    cmd->draw = draw;
+    cmd->data = data;
+    return 1;
+}
+
+// Stable LSD radix sort of the keys, 8 bits per pass. A pass is skipped when every
+// key has the same digit (common for the layer and surface bytes). Returns the
+// buffer holding the sorted order.
+static int trier_commandes(RenderQueue *queue) {
+    int n = queue->count;
+    int from = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        const Uint32 *keys = queue->keys[from];
+        const Uint16 *order = queue->order[from];
+        int counts[256] = {0};
+        for (int i = 0; i < n; i++) {
+            counts[(keys[i] >> shift) & 0xFF]++;
+        }
+        if (counts[(keys[0] >> shift) & 0xFF] == n) continue;
+        
+        int start = 0;
+        for (int d = 0; d < 256; d++) {
+            int c = counts[d];
+            counts[d] = start;
+            start += c;
+        }
+        
+        Uint32 *outKeys = queue->keys[from ^ 1];
+        Uint16 *outOrder = queue->order[from ^ 1];
+        for (int i = 0; i < n; i++) {
+            int pos = counts[(keys[i] >> shift) & 0xFF]++;
+            outKeys[pos] = keys[i];
+            outOrder[pos] = order[i];
+        }
+        from ^= 1;
+    }
+    return from;
+}
+
+void render_flush(RenderQueue *queue, SDL_Surface *screen) {
+    memset(queue->layerDraws, 0, sizeof(queue->layerDraws));
+    queue->surfaceSwitches = 0;
+    
+    if (queue->count > 0) {
+        int sorted = trier_commandes(queue);
+        SDL_Surface *last = NULL;
+        for (int i = 0; i < queue->count; i++) {
+            RenderCommand *cmd = &queue->commands[queue->order[sorted][i]];
+            queue->layerDraws[queue->keys[sorted][i] >> 24]++;
+            if (cmd->draw) {
+                cmd->draw(screen, cmd->data);
+                continue;
+            }
+            
+            if (cmd->surface != last) {
+                queue->surfaceSwitches++;
+                last = cmd->surface;
+            }
+            SDL_Rect src = cmd->src;
+            SDL_Rect dest = {cmd->x, cmd->y, 0, 0};
+            SDL_BlitSurface(cmd->surface, &src, screen, &dest);
+        }
+    }
+    
+    // Ready for the next frame
+    queue->count = 0;
+    queue->surfaceCount = 0;
+}
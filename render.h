@@ -0,0 +1,61 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <SDL/SDL.h>
+#include "spritesheet.h"
+
+// Frame render queue: subsystems submit draw commands in any order, render_flush
+// radix-sorts them by (layer, depth, source surface) and executes them.
+// Commands on the same layer and depth are grouped by source surface.
+#define RENDER_MAX_COMMANDS 1024
+#define RENDER_MAX_SURFACES 254   // Distinct sources per frame; the rest share one group
+
+// Layers, drawn in this order
+typedef enum {
+    LAYER_BACKGROUND,
+    LAYER_WORLD,                  // Characters, sorted by depth (screen y of their feet)
+    LAYER_LIGHTING,               // Darkness overlay
+    LAYER_EFFECTS,                // Particles, on top of the darkness
+    LAYER_OVERLAY,                // Health bars
+    LAYER_UI,                     // Minimap, HUD
+    RENDER_LAYER_COUNT
+} RenderLayer;
+
+// Custom drawing (full screen passes...), run at its place in the order
+typedef void (*RenderCallback)(SDL_Surface *screen, void *data);
+
+typedef struct {
+    SDL_Surface *surface;         // Blit source, NULL for a callback
+    SDL_Rect src;
+    Sint16 x;                     // Screen position of the blit
+    Sint16 y;
+    RenderCallback draw;
+    void *data;                   // Must stay valid until render_flush
+} RenderCommand;
+
+typedef struct {
+    const SDL_PixelFormat *format;          // Target format, for surfaces built while submitting
+    RenderCommand commands[RENDER_MAX_COMMANDS];
+    Uint32 keys[2][RENDER_MAX_COMMANDS];    // Sort keys and their command indices,
+    Uint16 order[2][RENDER_MAX_COMMANDS];   // ping-ponged by the radix passes
+    int count;
+    SDL_Surface *surfaces[RENDER_MAX_SURFACES]; // Surface ids of this frame (id = index + 1)
+    int surfaceCount;
+    
+    // Profiling, filled by render_flush
+    int layerDraws[RENDER_LAYER_COUNT];     // Commands executed per layer
+    int surfaceSwitches;                    // Source surface changes between consecutive commands
+    int dropped;                            // Commands lost to a full queue since init
+} RenderQueue;
+
+void init_render_queue(RenderQueue *queue, const SDL_PixelFormat *format);
+
+// Submit. src NULL blits the whole surface. Returns 0 (command dropped) if the queue is full.
+int render_blit(RenderQueue *queue, RenderLayer layer, int depth, SDL_Surface *surface, const SDL_Rect *src, int x, int y);
+int render_sprite(RenderQueue *queue, RenderLayer layer, int depth, SDL_Surface *image, const SpriteFrame *frame, int x, int y); // Same as blit_sprite_frame
+int render_callback(RenderQueue *queue, RenderLayer layer, int depth, RenderCallback draw, void *data);
+
+// Sort and execute every submitted command, then empty the queue
+void render_flush(RenderQueue *queue, SDL_Surface *screen);
+
+#endif // RENDER_H
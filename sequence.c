@@ -0,0 +1,66 @@
+#include <stdio.h>
+#include "sequence.h"
+
+void start_sequence(Sequence *seq, SequenceStep step, void *data, Uint32 now) {
+    seq->step = step;
+    seq->data = data;
+    seq->line = 0;
+    seq->now = now;
+    seq->wake = now;
+    seq->tweenStart = now;
+    seq->tweenEnd = now;
+    seq->tweenOver = 1;
+}
+
+int run_sequence(Sequence *seq, Uint32 now) {
+    if (seq->line < 0) return SEQ_DONE;
+    if ((Sint32)(now - seq->wake) < 0) return SEQ_RUNNING; // Still waiting: not resumed
+    
+    seq->now = now;
+    return seq->step(seq);
+}
+
+void sequence_tween(Sequence *seq, Uint32 ms) {
+    seq->tweenStart = seq->now;
+    seq->tweenEnd = seq->now + ms;
+    seq->tweenOver = 0;
+}
+
+int sequence_tweening(Sequence *seq) {
+    if (seq->tweenOver) return 0;
+    if (sequence_progress(seq) == FIX_ONE) seq->tweenOver = 1; // Run the final pass, then stop
+    return 1;
+}
+
+fixed sequence_progress(const Sequence *seq) {
+    Sint32 elapsed = (Sint32)(seq->now - seq->tweenStart);
+    Sint32 duration = (Sint32)(seq->tweenEnd - seq->tweenStart);
+    if (elapsed >= duration) return FIX_ONE;
+    if (elapsed <= 0) return 0;
+    return (fixed)((Sint64)elapsed * FIX_ONE / duration);
+}
+
+void init_sequencer(Sequencer *sequencer) {
+    sequencer->count = 0;
+}
+
+int sequencer_start(Sequencer *sequencer, SequenceStep step, void *data, Uint32 now) {
+    if (sequencer->count == SEQUENCE_MAX) {
+        printf("Too many sequences running\n");
+        return 0;
+    }
+    start_sequence(&sequencer->sequences[sequencer->count++], step, data, now);
+    return 1;
+}
+
+void sequencer_update(Sequencer *sequencer, Uint32 now) {
+    int i = 0;
+    while (i < sequencer->count) {
+        if (run_sequence(&sequencer->sequences[i], now) == SEQ_DONE) {
+            // Sequences started during this update land at the end and run this frame too
+            sequencer->sequences[i] = sequencer->sequences[--sequencer->count];
+        } else {
+            i++;
+        }
+    }
+}
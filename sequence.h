@@ -0,0 +1,78 @@
+#ifndef SEQUENCE_H
+#define SEQUENCE_H
+
+#include <SDL/SDL.h>
+#include "fixedpoint.h"
+
+// Timed sequences written as straight-line code ("wait 500 ms, tween the zoom, wait...")
+// and resumed once per frame, without blocking it. They are stackless coroutines: the
+// step function is re-entered at the last SEQ_ point, so local variables do not survive
+// a wait or a yield; keep the state in the sequence's data. One SEQ_ macro per line.
+//
+//     static int clignoter(Sequence *seq) {
+//         Thing *t = seq->data;
+//         SEQ_BEGIN(seq);
+//         SEQ_WAIT(seq, 500);
+//         SEQ_TWEEN(seq, 300) {
+//             t->alpha = 255 * sequence_progress(seq) / FIX_ONE;
+//             SEQ_YIELD(seq);
+//         }
+//         SEQ_END(seq);
+//     }
+
+typedef enum {
+    SEQ_RUNNING,
+    SEQ_DONE
+} SequenceStatus;
+
+typedef struct Sequence Sequence;
+typedef int (*SequenceStep)(Sequence *seq); // Returns a SequenceStatus
+
+struct Sequence {
+    SequenceStep step;
+    void *data;
+    int line;                     // Resume point, -1 once finished
+    Uint32 now;                   // Time of the current resume (ms)
+    Uint32 wake;                  // Not resumed before this time (SEQ_WAIT)
+    Uint32 tweenStart;            // Bounds of the current SEQ_TWEEN
+    Uint32 tweenEnd;
+    int tweenOver;                // The pass at FIX_ONE has run
+};
+
+#define SEQ_BEGIN(seq) switch ((seq)->line) { case 0:
+
+#define SEQ_END(seq) } (seq)->line = -1; return SEQ_DONE
+
+// Resume on the next frame
+#define SEQ_YIELD(seq) do { (seq)->line = __LINE__; return SEQ_RUNNING; case __LINE__:; } while (0)
+
+// Resume once ms milliseconds have passed; the step function is not even called meanwhile
+#define SEQ_WAIT(seq, ms) do { (seq)->wake = (seq)->now + (ms); (seq)->line = __LINE__; return SEQ_RUNNING; case __LINE__:; } while (0)
+
+// Resume on the first frame where cond is true
+#define SEQ_WAIT_UNTIL(seq, cond) do { if (!(cond)) { (seq)->line = __LINE__; return SEQ_RUNNING; \
+                                           case __LINE__: if (!(cond)) return SEQ_RUNNING; } } while (0)
+
+// Loop over the frames of the next ms milliseconds; the body must SEQ_YIELD, and
+// sequence_progress goes from 0 to FIX_ONE (the last pass sees FIX_ONE)
+#define SEQ_TWEEN(seq, ms) for (sequence_tween((seq), (ms)); sequence_tweening(seq); )
+
+void start_sequence(Sequence *seq, SequenceStep step, void *data, Uint32 now);
+int run_sequence(Sequence *seq, Uint32 now); // Resume if due; returns a SequenceStatus
+void sequence_tween(Sequence *seq, Uint32 ms);
+int sequence_tweening(Sequence *seq);
+fixed sequence_progress(const Sequence *seq);
+
+// Fixed-capacity set of sequences run together
+#define SEQUENCE_MAX 256
+
+typedef struct {
+    Sequence sequences[SEQUENCE_MAX]; // Running ones first, finished ones are swapped out
+    int count;
+} Sequencer;
+
+void init_sequencer(Sequencer *sequencer);
+int sequencer_start(Sequencer *sequencer, SequenceStep step, void *data, Uint32 now); // Returns 0 if full
+void sequencer_update(Sequencer *sequencer, Uint32 now);
+
+#endif // SEQUENCE_H
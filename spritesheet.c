@@ -0,0 +1,345 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL/SDL.h>
+#include "spritesheet.h"
+
+// Read a raw pixel value whatever the surface depth (surface must be locked)
+static Uint32 read_pixel(SDL_Surface *image, int x, int y) {
+    Uint32 pixel = 0;
+    Uint8 *p = (Uint8 *)image->pixels + y * image->pitch + x * image->format->BytesPerPixel;
+    memcpy(&pixel, p, image->format->BytesPerPixel);
+    return pixel;
+}
+
+// A pixel is visible if it has some alpha, or differs from the color key
+static int pixel_is_opaque(SDL_Surface *image, Uint32 pixel) {
+    if (image->format->Amask) {
+        return (pixel & image->format->Amask) != 0;
+    }
+    if (image->flags & SDL_SRCCOLORKEY) {
+        return pixel != image->format->colorkey;
+    }
+    return 1; // No transparency information - the whole cell is visible
+}
+
+// Shrink a cell to the bounding box of its opaque pixels
+void trim_sprite_frame(SDL_Surface *image, SDL_Rect cell, SpriteFrame *frame) {
+    int minX = cell.w, minY = cell.h, maxX = -1, maxY = -1;
+
+    // Default pivot: bottom center of the untrimmed cell (feet of the character)
+    frame->pivot_x = cell.w / 2;
+    frame->pivot_y = cell.h;
+
+    if (SDL_MUSTLOCK(image)) SDL_LockSurface(image);
+    for (int y = 0; y < cell.h; y++) {
+        for (int x = 0; x < cell.w; x++) {
+            if (pixel_is_opaque(image, read_pixel(image, cell.x + x, cell.y + y))) {
+                if (x < minX) minX = x;
+                if (x > maxX) maxX = x;
+                if (y < minY) minY = y;
+                if (y > maxY) maxY = y;
+            }
+        }
+    }
+    if (SDL_MUSTLOCK(image)) SDL_UnlockSurface(image);
+
+    if (maxX < 0) {
+        // Fully transparent cell - nothing to blit
+        frame->src.x = cell.x;
+        frame->src.y = cell.y;
+        frame->src.w = 0;
+        frame->src.h = 0;
+        frame->offset_x = 0;
+        frame->offset_y = 0;
+        return;
+    }
+
+    frame->src.x = cell.x + minX;
+    frame->src.y = cell.y + minY;
+    frame->src.w = maxX - minX + 1;
+    frame->src.h = maxY - minY + 1;
+    frame->offset_x = minX;
+    frame->offset_y = minY;
+}
+
+// Build metadata for a uniform grid sheet, used when no metadata file exists
+void spritesheet_from_grid(SpriteSheet *sheet, SDL_Surface *image, int cols, int rows) {
+    memset(sheet, 0, sizeof(*sheet));
+    sheet->cell_w = image->w / cols;
+    sheet->cell_h = image->h / rows;
+
+    for (int row = 0; row < rows && sheet->anim_count < SPRITE_MAX_ANIMS; row++) {
+        SpriteAnim *anim = &sheet->anims[sheet->anim_count++];
+        snprintf(anim->name, sizeof(anim->name), "row%d", row);
+
+        for (int col = 0; col < cols && anim->count < SPRITE_MAX_ANIM_FRAMES; col++) {
+            if (sheet->frame_count >= SPRITE_MAX_FRAMES) break;
+
+            SDL_Rect cell = {col * sheet->cell_w, row * sheet->cell_h, sheet->cell_w, sheet->cell_h};
+            trim_sprite_frame(image, cell, &sheet->frames[sheet->frame_count]);
+            anim->frames[anim->count++] = sheet->frame_count++;
+        }
+    }
+}
+
+// Trims stored in metadata only cover the base layer; a composed sheet may draw outside them
+void spritesheet_retrim(SpriteSheet *sheet, SDL_Surface *image) {
+    for (int i = 0; i < sheet->frame_count; i++) {
+        SpriteFrame *frame = &sheet->frames[i];
+        Sint16 pivotX = frame->pivot_x, pivotY = frame->pivot_y;
+        SDL_Rect cell = {frame->src.x - frame->offset_x, frame->src.y - frame->offset_y, sheet->cell_w, sheet->cell_h};
+
+        if (cell.x < 0 || cell.y < 0 || cell.x + cell.w > image->w || cell.y + cell.h > image->h) continue;
+
+        trim_sprite_frame(image, cell, frame);
+        frame->pivot_x = pivotX;
+        frame->pivot_y = pivotY;
+    }
+}
+
+// "assets/textures/player_sprite.png" -> "assets/textures/player_sprite.sheet"
+void spritesheet_meta_path(const char *imagePath, char *metaPath, size_t size) {
+    snprintf(metaPath, size, "%s", imagePath);
+
+    char *dot = strrchr(metaPath, '.');
+    char *slash = strrchr(metaPath, '/');
+    if (dot && (!slash || dot > slash)) *dot = '\0';
+
+    size_t len = strlen(metaPath);
+    snprintf(metaPath + len, size - len, "%s", SPRITESHEET_META_EXT);
+}
+
+// Load a metadata file written by tools/sheetpack
+int load_spritesheet_meta(SpriteSheet *sheet, const char *metaPath, SDL_Surface *image) {
+    FILE *file = fopen(metaPath, "r");
+    if (file == NULL) {
+        return 0; // No metadata - caller falls back to a uniform grid
+    }
+
+    memset(sheet, 0, sizeof(*sheet));
+    char line[256];
+    int valid = 1;
+
+    while (valid && fgets(line, sizeof(line), file)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+
+        if (strncmp(line, "cell ", 5) == 0) {
+            if (sscanf(line + 5, "%d %d", &sheet->cell_w, &sheet->cell_h) != 2) valid = 0;
+        } else if (strncmp(line, "frame ", 6) == 0) {
+            int x, y, w, h, ox, oy, px, py;
+            if (sheet->frame_count >= SPRITE_MAX_FRAMES ||
+                sscanf(line + 6, "%d %d %d %d %d %d %d %d", &x, &y, &w, &h, &ox, &oy, &px, &py) != 8) {
+                valid = 0;
+                break;
+            }
+
+            // Reject metadata that does not match the loaded image (e.g. fallback surface)
+            if (x < 0 || y < 0 || w < 0 || h < 0 || x + w > image->w || y + h > image->h) {
+                valid = 0;
+                break;
+            }
+
+            SpriteFrame *frame = &sheet->frames[sheet->frame_count++];
+            frame->src.x = x;
+            frame->src.y = y;
+            frame->src.w = w;
+            frame->src.h = h;
+            frame->offset_x = ox;
+            frame->offset_y = oy;
+            frame->pivot_x = px;
+            frame->pivot_y = py;
+        } else if (strncmp(line, "anim ", 5) == 0) {
+            if (sheet->anim_count >= SPRITE_MAX_ANIMS) continue;
+
+            SpriteAnim *anim = &sheet->anims[sheet->anim_count];
+            int consumed = 0;
+            if (sscanf(line + 5, "%15s%n", anim->name, &consumed) != 1) {
+                valid = 0;
+                break;
+            }
+
+            char *cursor = line + 5 + consumed;
+            int index;
+            while (anim->count < SPRITE_MAX_ANIM_FRAMES && sscanf(cursor, "%d%n", &index, &consumed) == 1) {
+                if (index < 0 || index >= sheet->frame_count) {
+                    valid = 0;
+                    break;
+                }
+                anim->frames[anim->count++] = index;
+                cursor += consumed;
+            }
+            sheet->anim_count++;
+        }
+    }
+    fclose(file);
+
+    if (!valid || sheet->frame_count == 0 || sheet->cell_w <= 0 || sheet->cell_h <= 0) {
+        printf("Ignoring invalid sprite sheet metadata %s\n", metaPath);
+        return 0;
+    }
+    return 1;
+}
+
+// Write metadata in the format read by load_spritesheet_meta
+int save_spritesheet_meta(const SpriteSheet *sheet, const char *metaPath) {
+    FILE *file = fopen(metaPath, "w");
+    if (file == NULL) {
+        printf("Unable to write sprite sheet metadata %s\n", metaPath);
+        return 0;
+    }
+
+    fprintf(file, "# Sprite sheet metadata - generated by tools/sheetpack, do not edit\n");
+    fprintf(file, "# frame <x> <y> <w> <h> <offset_x> <offset_y> <pivot_x> <pivot_y>\n");
+    fprintf(file, "cell %d %d\n", sheet->cell_w, sheet->cell_h);
+
+    for (int i = 0; i < sheet->frame_count; i++) {
+        const SpriteFrame *f = &sheet->frames[i];
+        fprintf(file, "frame %d %d %d %d %d %d %d %d\n",
+                f->src.x, f->src.y, f->src.w, f->src.h,
+                f->offset_x, f->offset_y, f->pivot_x, f->pivot_y);
+    }
+
+    for (int i = 0; i < sheet->anim_count; i++) {
+        fprintf(file, "anim %s", sheet->anims[i].name);
+        for (int j = 0; j < sheet->anims[i].count; j++) {
+            fprintf(file, " %d", sheet->anims[i].frames[j]);
+        }
+        fprintf(file, "\n");
+    }
+
+    fclose(file);
+    return 1;
+}
+
+// Find an animation by name, returns -1 if missing
+int spritesheet_find_anim(const SpriteSheet *sheet, const char *name) {
+    for (int i = 0; i < sheet->anim_count; i++) {
+        if (strcmp(sheet->anims[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+// Blit only the visible pixels of a frame; (x, y) is the untrimmed cell origin
+void blit_sprite_frame(SDL_Surface *image, const SpriteFrame *frame, SDL_Surface *screen, int x, int y) {
+    if (frame->src.w == 0 || frame->src.h == 0) return;
+
+    SDL_Rect src = frame->src;
+    SDL_Rect dest = {x + frame->offset_x, y + frame->offset_y, 0, 0};
+    SDL_BlitSurface(image, &src, screen, &dest);
+}
+
+int build_sprite_mask(SpriteMask *mask, SDL_Surface *image, const SpriteFrame *frame) {
+    mask->w = frame->src.w;
+    mask->h = frame->src.h;
+    mask->words = (mask->w + 63) / 64;
+    mask->bits = NULL;
+    if (mask->w == 0 || mask->h == 0) return 1;
+
+    mask->bits = calloc(mask->words * mask->h, sizeof(Uint64));
+    if (!mask->bits) {
+        printf("Unable to allocate sprite collision mask\n");
+        return 0;
+    }
+
+    if (SDL_MUSTLOCK(image)) SDL_LockSurface(image);
+    for (int y = 0; y < mask->h; y++) {
+        Uint64 *row = mask->bits + y * mask->words;
+        for (int x = 0; x < mask->w; x++) {
+            if (pixel_is_opaque(image, read_pixel(image, frame->src.x + x, frame->src.y + y))) {
+                row[x >> 6] |= (Uint64)1 << (x & 63);
+            }
+        }
+    }
+    if (SDL_MUSTLOCK(image)) SDL_UnlockSurface(image);
+    return 1;
+}
+
+void free_sprite_mask(SpriteMask *mask) {
+    free(mask->bits);
+    mask->bits = NULL;
+}
+
+// 64 mask bits of row y starting at column x (bits past the row are 0)
+static Uint64 mask_bits(const SpriteMask *mask, int y, int x) {
+    const Uint64 *row = mask->bits + y * mask->words;
+    int i = x >> 6, shift = x & 63;
+    Uint64 bits = i < mask->words ? row[i] >> shift : 0;
+    if (shift && i + 1 < mask->words) bits |= row[i + 1] << (64 - shift);
+    return bits;
+}
+
+int sprite_masks_overlap(const SpriteMask *a, int ax, int ay, const SpriteMask *b, int bx, int by) {
+    if (!a->bits || !b->bits) return 0;
+
+    int x0 = ax > bx ? ax : bx;
+    int y0 = ay > by ? ay : by;
+    int x1 = ax + a->w < bx + b->w ? ax + a->w : bx + b->w;
+    int y1 = ay + a->h < by + b->h ? ay + a->h : by + b->h;
+
+    // AND the shifted rows 64 pixels at a time
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x += 64) {
+            if (mask_bits(a, y - ay, x - ax) & mask_bits(b, y - by, x - bx)) return 1;
+        }
+    }
+    return 0;
+}
+
+// Compose overlay (clothing, accessories...) over base into a new surface, once per selection
+SDL_Surface* compose_sprite_layers(SDL_Surface *base, SDL_Surface *overlay) {
+    SDL_Surface *result = SDL_CreateRGBSurface(SDL_SWSURFACE, base->w, base->h, 32,
+                                               0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+    if (!result) {
+        printf("Unable to compose sprite layers: %s\n", SDL_GetError());
+        return NULL;
+    }
+
+    // Copy the base layer as is, alpha included
+    Uint32 baseFlags = base->flags & (SDL_SRCALPHA | SDL_RLEACCEL);
+    Uint8 baseAlpha = base->format->alpha;
+    SDL_FillRect(result, NULL, 0);
+    SDL_SetAlpha(base, 0, baseAlpha);
+    SDL_BlitSurface(base, NULL, result, NULL);
+    SDL_SetAlpha(base, baseFlags, baseAlpha);
+
+    if (overlay) {
+        int w = overlay->w < result->w ? overlay->w : result->w;
+        int h = overlay->h < result->h ? overlay->h : result->h;
+
+        if (SDL_MUSTLOCK(overlay)) SDL_LockSurface(overlay);
+        for (int y = 0; y < h; y++) {
+            Uint32 *dst = (Uint32 *)((Uint8 *)result->pixels + y * result->pitch);
+            for (int x = 0; x < w; x++) {
+                Uint32 pixel = read_pixel(overlay, x, y);
+                if (!pixel_is_opaque(overlay, pixel)) continue;
+
+                Uint8 sr, sg, sb, sa, dr, dg, db, da;
+                SDL_GetRGBA(pixel, overlay->format, &sr, &sg, &sb, &sa);
+                if (sa == SDL_ALPHA_OPAQUE) {
+                    dst[x] = SDL_MapRGBA(result->format, sr, sg, sb, sa);
+                    continue;
+                }
+
+                // Porter-Duff "over" so clothing may also cover transparent base pixels
+                SDL_GetRGBA(dst[x], result->format, &dr, &dg, &db, &da);
+                int below = da * (255 - sa) / 255;
+                int outA = sa + below;
+                dst[x] = SDL_MapRGBA(result->format,
+                                     (sr * sa + dr * below) / outA,
+                                     (sg * sa + dg * below) / outA,
+                                     (sb * sa + db * below) / outA,
+                                     outA);
+            }
+        }
+        if (SDL_MUSTLOCK(overlay)) SDL_UnlockSurface(overlay);
+    }
+
+    // Convert once so the composed sheet blits as fast as any other sprite
+    SDL_Surface *optimized = SDL_DisplayFormatAlpha(result);
+    if (optimized) {
+        SDL_FreeSurface(result);
+        return optimized;
+    }
+    return result;
+}
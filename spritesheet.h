@@ -0,0 +1,71 @@
+#ifndef SPRITESHEET_H
+#define SPRITESHEET_H
+
+#include <stddef.h>
+#include <SDL/SDL.h>
+
+// Sheet metadata limits
+#define SPRITE_MAX_FRAMES 64
+#define SPRITE_MAX_ANIMS 8
+#define SPRITE_MAX_ANIM_FRAMES 16
+#define SPRITE_ANIM_NAME_LEN 16
+
+// Extension of the metadata file written next to each sheet ("player_sprite.sheet")
+#define SPRITESHEET_META_EXT ".sheet"
+
+// One frame of a sprite sheet, trimmed to its opaque bounds
+typedef struct {
+    SDL_Rect src;                 // Trimmed rectangle inside the sheet
+    Sint16 offset_x;              // Trim offset from the untrimmed cell origin
+    Sint16 offset_y;
+    Sint16 pivot_x;               // Pivot point relative to the untrimmed cell origin
+    Sint16 pivot_y;
+} SpriteFrame;
+
+// 1-bit opacity mask of a trimmed frame: one row of Uint64 words per pixel row
+typedef struct {
+    int w;                        // Same size as the frame's src rect
+    int h;
+    int words;                    // Uint64 words per row
+    Uint64 *bits;                 // NULL for an empty frame
+} SpriteMask;
+
+// Named list of frames played in order (one per state: "idle", "walk", ...)
+typedef struct {
+    char name[SPRITE_ANIM_NAME_LEN];
+    int frames[SPRITE_MAX_ANIM_FRAMES]; // Indices into SpriteSheet.frames
+    int count;
+} SpriteAnim;
+
+// Sprite sheet metadata: frame rects, trim/pivot offsets and per-state frame lists
+typedef struct {
+    int cell_w;                   // Untrimmed frame size
+    int cell_h;
+    SpriteFrame frames[SPRITE_MAX_FRAMES];
+    int frame_count;
+    SpriteAnim anims[SPRITE_MAX_ANIMS];
+    int anim_count;
+} SpriteSheet;
+
+// Metadata loading and generation
+int load_spritesheet_meta(SpriteSheet *sheet, const char *metaPath, SDL_Surface *image); // Returns 1 if the file is valid for image
+int save_spritesheet_meta(const SpriteSheet *sheet, const char *metaPath);
+void spritesheet_meta_path(const char *imagePath, char *metaPath, size_t size);
+void spritesheet_from_grid(SpriteSheet *sheet, SDL_Surface *image, int cols, int rows); // One anim per row, frames trimmed
+void spritesheet_retrim(SpriteSheet *sheet, SDL_Surface *image); // Recompute trims for a composed copy of the sheet
+
+// Frame helpers
+void trim_sprite_frame(SDL_Surface *image, SDL_Rect cell, SpriteFrame *frame);
+int spritesheet_find_anim(const SpriteSheet *sheet, const char *name);
+void blit_sprite_frame(SDL_Surface *image, const SpriteFrame *frame, SDL_Surface *screen, int x, int y);
+
+// Opacity masks for pixel-perfect sprite collisions
+int build_sprite_mask(SpriteMask *mask, SDL_Surface *image, const SpriteFrame *frame); // Returns 0 if out of memory
+void free_sprite_mask(SpriteMask *mask);
+// Do two masks share an opaque pixel? (ax, ay) / (bx, by) are the positions of the trimmed rects
+int sprite_masks_overlap(const SpriteMask *a, int ax, int ay, const SpriteMask *b, int bx, int by);
+
+// Layer composition: new 32-bit surface with overlay drawn over base ("over" alpha blending)
+SDL_Surface* compose_sprite_layers(SDL_Surface *base, SDL_Surface *overlay);
+
+#endif // SPRITESHEET_H
@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include "timer.h"
+
+#define TIMER_MASK (TIMER_SLOTS - 1)
+
+static void init_list(TimerLink *head) {
+    head->next = head;
+    head->prev = head;
+}
+
+static void unlink_timer(TimerLink *link) {
+    link->prev->next = link->next;
+    link->next->prev = link->prev;
+    link->next = NULL;
+    link->prev = NULL;
+}
+
+static void append(TimerLink *head, TimerLink *link) {
+    link->prev = head->prev;
+    link->next = head;
+    head->prev->next = link;
+    head->prev = link;
+}
+
+// Move every timer of src to the empty list dst, leaving src empty
+static void splice(TimerLink *src, TimerLink *dst) {
+    if (src->next == src) {
+        init_list(dst);
+        return;
+    }
+    dst->next = src->next;
+    dst->prev = src->prev;
+    dst->next->prev = dst;
+    dst->prev->next = dst;
+    init_list(src);
+}
+
+// Slot from the distance to the expiry: the lowest level whose span covers it
+static void inserer_timer(TimerWheel *wheel, Timer *timer) {
+    Uint32 delta = timer->expires - wheel->next;
+    if ((Sint32)delta < 0) {
+        // Already due: fires on the next processed tick
+        append(&wheel->slots[0][wheel->next & TIMER_MASK], &timer->link);
+        return;
+    }
+    
+    int level = 0;
+    while (level < TIMER_LEVELS - 1 && delta >= 1u << ((level + 1) * TIMER_SLOT_BITS)) {
+        level++;
+    }
+    int slot = (timer->expires >> (level * TIMER_SLOT_BITS)) & TIMER_MASK;
+    append(&wheel->slots[level][slot], &timer->link);
+}
+
+// Redistribute the current slot of a level to the levels below. Returns the slot index,
+// 0 meaning the next level up is due as well.
+static int cascade(TimerWheel *wheel, int level) {
+    int slot = (wheel->next >> (level * TIMER_SLOT_BITS)) & TIMER_MASK;
+    TimerLink pending;
+    splice(&wheel->slots[level][slot], &pending);
+    while (pending.next != &pending) {
+        TimerLink *link = pending.next;
+        unlink_timer(link);
+        inserer_timer(wheel, (Timer *)link);
+    }
+    return slot;
+}
+
+void init_timer_wheel(TimerWheel *wheel, Uint32 now) {
+    for (int level = 0; level < TIMER_LEVELS; level++) {
+        for (int slot = 0; slot < TIMER_SLOTS; slot++) {
+            init_list(&wheel->slots[level][slot]);
+        }
+    }
+    wheel->next = now;
+}
+
+void timer_advance(TimerWheel *wheel, Uint32 now) {
+    while ((Sint32)(now - wheel->next) >= 0) {
+        int index = wheel->next & TIMER_MASK;
+        if (index == 0) {
+            for (int level = 1; level < TIMER_LEVELS && cascade(wheel, level) == 0; level++) {
+            }
+        }
+        wheel->next++;
+        
+        // Detach the slot first: callbacks may start timers that land in it again
+        TimerLink due;
+        splice(&wheel->slots[0][index], &due);
+        while (due.next != &due) {
+            Timer *timer = (Timer *)due.next;
+            unlink_timer(&timer->link);
+            if (timer->period) {
+                timer->expires += timer->period;
+                inserer_timer(wheel, timer);
+            }
+            timer->callback(timer->data);
+        }
+    }
+}
+
+void init_timer(Timer *timer, TimerCallback callback, void *data) {
+    timer->link.next = NULL;
+    timer->link.prev = NULL;
+    timer->expires = 0;
+    timer->period = 0;
+    timer->callback = callback;
+    timer->data = data;
+}
+
+void timer_start(TimerWheel *wheel, Timer *timer, Uint32 delay, Uint32 period) {
+    if (delay > TIMER_MAX_DELAY) {
+        printf("Timer delay of %u ms clamped\n", (unsigned)delay);
+        delay = TIMER_MAX_DELAY;
+    }
+    if (period > TIMER_MAX_DELAY) period = TIMER_MAX_DELAY;
+    
+    timer_cancel(timer);
+    timer->expires = wheel->next + delay;
+    timer->period = period;
+    inserer_timer(wheel, timer);
+}
+
+void timer_cancel(Timer *timer) {
+    if (timer->link.next) unlink_timer(&timer->link);
+}
+
+int timer_pending(const Timer *timer) {
+    return timer->link.next != NULL;
+}
+
+Uint32 timer_remaining(const TimerWheel *wheel, const Timer *timer) {
+    if (!timer_pending(timer)) return 0;
+    Sint32 left = (Sint32)(timer->expires - wheel->next);
+    return left > 0 ? (Uint32)left : 0;
+}
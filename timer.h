@@ -0,0 +1,45 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <SDL/SDL.h>
+
+// Hierarchical timing wheel, 1 tick = 1 ms. Level 0 holds the timers due in the next
+// TIMER_SLOTS ticks, each level above covers TIMER_SLOTS times more; their slots are
+// redistributed to the level below when the wheel reaches them.
+#define TIMER_LEVELS 4
+#define TIMER_SLOT_BITS 6
+#define TIMER_SLOTS (1 << TIMER_SLOT_BITS)
+#define TIMER_MAX_DELAY ((1u << (TIMER_LEVELS * TIMER_SLOT_BITS)) - 1) // About 4.6 hours
+
+typedef void (*TimerCallback)(void *data);
+
+// Links of the intrusive slot lists
+typedef struct TimerLink {
+    struct TimerLink *next;
+    struct TimerLink *prev;
+} TimerLink;
+
+// Timer embedded in its owner: starting and cancelling it never allocates
+typedef struct {
+    TimerLink link;               // First member: a link is also its timer
+    Uint32 expires;               // Tick it fires at
+    Uint32 period;                // Re-armed with this delay after firing, 0 for a one-shot
+    TimerCallback callback;
+    void *data;
+} Timer;
+
+typedef struct {
+    TimerLink slots[TIMER_LEVELS][TIMER_SLOTS]; // List heads
+    Uint32 next;                  // Next tick to process
+} TimerWheel;
+
+void init_timer_wheel(TimerWheel *wheel, Uint32 now);
+void timer_advance(TimerWheel *wheel, Uint32 now); // Fire everything due up to now (included)
+
+void init_timer(Timer *timer, TimerCallback callback, void *data);
+void timer_start(TimerWheel *wheel, Timer *timer, Uint32 delay, Uint32 period); // O(1), restarts a pending timer
+void timer_cancel(Timer *timer);                                                 // O(1), no-op if not pending
+int timer_pending(const Timer *timer);
+Uint32 timer_remaining(const TimerWheel *wheel, const Timer *timer);             // Ms before it fires, 0 if not pending
+
+#endif // TIMER_H
@@ -0,0 +1,266 @@
+// atlaspack - pack sprite and UI images into texture atlas pages
+//
+// Usage: atlaspack <output_dir> <page_size> <image.png...>
+//
+// Images are packed with a skyline bottom-left packer into square pages of
+// page_size pixels (cropped to the used area), written as 32-bit TGA files so
+// alpha is kept without extra libraries. A lookup table (atlas.txt) maps each
+// input path, exactly as given on the command line, to its page and sub-rect;
+// load_asset_image() uses it to hand out views into the pages instead of
+// decoding every image separately.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL/SDL.h>
+#include <SDL/SDL_image.h>
+#include "atlas.h"
+
+#define MAX_SKYLINE 512
+
+// One input image and where it ends up
+typedef struct {
+    const char *path;
+    SDL_Surface *image;
+    int page;
+    SDL_Rect rect;
+} PackItem;
+
+// Skyline segment: the top of the packed area between x and x + w is at y
+typedef struct {
+    int x, y, w;
+} SkylineNode;
+
+typedef struct {
+    SkylineNode nodes[MAX_SKYLINE];
+    int count;
+    int size;
+    int used_w, used_h;
+} Skyline;
+
+static void skyline_init(Skyline *sky, int size) {
+    sky->count = 1;
+    sky->nodes[0].x = 0;
+    sky->nodes[0].y = 0;
+    sky->nodes[0].w = size;
+    sky->size = size;
+    sky->used_w = 0;
+    sky->used_h = 0;
+}
+
+// Lowest y at which a w x h rect fits when its left edge is on node i, or -1
+static int skyline_fit(const Skyline *sky, int i, int w, int h) {
+    int x = sky->nodes[i].x;
+    if (x + w > sky->size) return -1;
+
+    int y = 0;
+    int remaining = w;
+    while (remaining > 0) {
+        if (i >= sky->count) return -1;
+        if (sky->nodes[i].y > y) y = sky->nodes[i].y;
+        if (y + h > sky->size) return -1;
+        remaining -= sky->nodes[i].w;
+        i++;
+    }
+    return y;
+}
+
+// Find the bottom-left position for a rect and raise the skyline over it
+static int skyline_insert(Skyline *sky, int w, int h, SDL_Rect *out) {
+    int best = -1, bestY = sky->size, bestX = sky->size;
+
+    for (int i = 0; i < sky->count; i++) {
+        int y = skyline_fit(sky, i, w, h);
+        if (y >= 0 && (y < bestY || (y == bestY && sky->nodes[i].x < bestX))) {
+            best = i;
+            bestY = y;
+            bestX = sky->nodes[i].x;
+        }
+    }
+    if (best < 0 || sky->count >= MAX_SKYLINE) return 0;
+
+    // Insert the new node and shrink/remove the nodes it now covers
+    memmove(&sky->nodes[best + 1], &sky->nodes[best], (sky->count - best) * sizeof(SkylineNode));
+    sky->count++;
+    sky->nodes[best].x = bestX;
+    sky->nodes[best].y = bestY + h;
+    sky->nodes[best].w = w;
+
+    for (int i = best + 1; i < sky->count; i++) {
+        SkylineNode *prev = &sky->nodes[i - 1];
+        SkylineNode *node = &sky->nodes[i];
+        if (node->x >= prev->x + prev->w) break;
+
+        int shrink = prev->x + prev->w - node->x;
+        node->x += shrink;
+        node->w -= shrink;
+        if (node->w > 0) break;
+
+        memmove(node, node + 1, (sky->count - i - 1) * sizeof(SkylineNode));
+        sky->count--;
+        i--;
+    }
+
+    // Merge neighbours at the same height
+    for (int i = 0; i + 1 < sky->count; i++) {
+        if (sky->nodes[i].y == sky->nodes[i + 1].y) {
+            sky->nodes[i].w += sky->nodes[i + 1].w;
+            memmove(&sky->nodes[i + 1], &sky->nodes[i + 2], (sky->count - i - 2) * sizeof(SkylineNode));
+            sky->count--;
+            i--;
+        }
+    }
+
+    out->x = bestX;
+    out->y = bestY;
+    out->w = w;
+    out->h = h;
+    if (bestX + w > sky->used_w) sky->used_w = bestX + w;
+    if (bestY + h > sky->used_h) sky->used_h = bestY + h;
+    return 1;
+}
+
+// Tallest first gives the skyline packer its best results
+static int compare_items(const void *a, const void *b) {
+    const PackItem *ia = a, *ib = b;
+    if (ia->image->h != ib->image->h) return ib->image->h - ia->image->h;
+    return ib->image->w - ia->image->w;
+}
+
+// 32-bit surface whose bytes are laid out B, G, R, A as TGA expects
+static SDL_Surface *create_bgra_surface(int w, int h) {
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    return SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, 32, 0x0000FF00, 0x00FF0000, 0xFF000000, 0x000000FF);
+#else
+    return SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+#endif
+}
+
+// Uncompressed 32-bit top-left origin TGA
+static int write_tga(SDL_Surface *page, const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        printf("Unable to write atlas page %s\n", path);
+        return 0;
+    }
+
+    Uint8 header[18] = {0};
+    header[2] = 2;                          // Uncompressed true-color
+    header[12] = page->w & 0xFF;
+    header[13] = (page->w >> 8) & 0xFF;
+    header[14] = page->h & 0xFF;
+    header[15] = (page->h >> 8) & 0xFF;
+    header[16] = 32;                        // Bits per pixel
+    header[17] = 0x28;                      // 8 alpha bits, top-left origin
+    fwrite(header, 1, sizeof(header), file);
+
+    for (int y = 0; y < page->h; y++) {
+        fwrite((Uint8 *)page->pixels + y * page->pitch, 4, page->w, file);
+    }
+
+    fclose(file);
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 4) {
+        printf("Usage: %s <output_dir> <page_size> <image.png...>\n", argv[0]);
+        return 1;
+    }
+
+    const char *outDir = argv[1];
+    int pageSize = atoi(argv[2]);
+    if (pageSize <= 0) {
+        printf("Invalid page size %s\n", argv[2]);
+        return 1;
+    }
+
+    int count = 0;
+    PackItem *items = calloc(argc - 3, sizeof(PackItem));
+    for (int i = 3; i < argc; i++) {
+        SDL_Surface *image = IMG_Load(argv[i]);
+        if (!image) {
+            printf("Skipping %s: %s\n", argv[i], IMG_GetError());
+            continue;
+        }
+        if (image->w > pageSize || image->h > pageSize) {
+            printf("Skipping %s: %dx%d does not fit a %d page\n", argv[i], image->w, image->h, pageSize);
+            SDL_FreeSurface(image);
+            continue;
+        }
+        items[count].path = argv[i];
+        items[count].image = image;
+        count++;
+    }
+    qsort(items, count, sizeof(PackItem), compare_items);
+
+    // Fill pages one after another until every image is placed
+    Skyline pages[ATLAS_MAX_PAGES];
+    int pageCount = 0;
+    for (int i = 0; i < count; i++) {
+        int placed = 0;
+        for (int p = 0; p < pageCount && !placed; p++) {
+            if (skyline_insert(&pages[p], items[i].image->w, items[i].image->h, &items[i].rect)) {
+                items[i].page = p;
+                placed = 1;
+            }
+        }
+        if (!placed && pageCount < ATLAS_MAX_PAGES) {
+            skyline_init(&pages[pageCount], pageSize);
+            if (skyline_insert(&pages[pageCount], items[i].image->w, items[i].image->h, &items[i].rect)) {
+                items[i].page = pageCount;
+                placed = 1;
+            }
+            pageCount++;
+        }
+        if (!placed) {
+            printf("Atlas full, %s stays a separate file\n", items[i].path);
+            items[i].page = -1;
+        }
+    }
+
+    // Write the pages, cropped to the area actually used
+    char path[256];
+    int ok = 1;
+    for (int p = 0; p < pageCount; p++) {
+        SDL_Surface *page = create_bgra_surface(pages[p].used_w, pages[p].used_h);
+        SDL_FillRect(page, NULL, 0);
+
+        for (int i = 0; i < count; i++) {
+            if (items[i].page != p) continue;
+            SDL_SetAlpha(items[i].image, 0, SDL_ALPHA_OPAQUE); // Copy alpha instead of blending
+            SDL_Rect dest = items[i].rect;
+            SDL_BlitSurface(items[i].image, NULL, page, &dest);
+        }
+
+        snprintf(path, sizeof(path), "%s/atlas%d.tga", outDir, p);
+        ok &= write_tga(page, path);
+        printf("%s: %dx%d\n", path, page->w, page->h);
+        SDL_FreeSurface(page);
+    }
+
+    // Lookup table read by init_atlas()
+    snprintf(path, sizeof(path), "%s/%s", outDir, ATLAS_INDEX_FILE);
+    FILE *index = fopen(path, "w");
+    if (index == NULL) {
+        printf("Unable to write atlas index %s\n", path);
+        ok = 0;
+    } else {
+        fprintf(index, "# Texture atlas lookup table - generated by tools/atlaspack, do not edit\n");
+        for (int p = 0; p < pageCount; p++) {
+            fprintf(index, "page %d atlas%d.tga\n", p, p);
+        }
+        for (int i = 0; i < count; i++) {
+            if (items[i].page < 0) continue;
+            fprintf(index, "sprite %s %d %d %d %d %d\n", items[i].path, items[i].page,
+                    items[i].rect.x, items[i].rect.y, items[i].rect.w, items[i].rect.h);
+        }
+        fclose(index);
+    }
+
+    for (int i = 0; i < count; i++) {
+        SDL_FreeSurface(items[i].image);
+    }
+    free(items);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+// lightbench - time the darkness overlay on a scrolling 1280x720 view
+//
+// Usage: lightbench [frames]
+//
+// Lights a 6400x720 level with a row of static lanterns and four dynamic lights that
+// follow the view, then times lightmap_apply frame by frame while the camera scrolls
+// 7 pixels per frame (wrapping back to the start). The static cache is built before
+// timing starts, so the figure is the per-frame cost seen during play.
+// Built twice by "make bench": with SSE2 and with the scalar fallback (-mno-sse2).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <SDL/SDL.h>
+#include "lighting.h"
+
+#define BENCH_W 1280
+#define BENCH_H 720
+#define BENCH_LEVEL_W 6400
+#define BENCH_LANTERNS 16
+#define BENCH_SCROLL 7            // Camera pixels per frame
+
+int main(int argc, char *argv[]) {
+    int frames = argc > 1 ? atoi(argv[1]) : 600;
+    if (frames <= 0) {
+        printf("Invalid frame count %s\n", argv[1]);
+        return 1;
+    }
+
+    SDL_Surface *screen = SDL_CreateRGBSurface(SDL_SWSURFACE, BENCH_W, BENCH_H, 32,
+                                               0xFF0000, 0x00FF00, 0x0000FF, 0);
+    if (!screen) {
+        printf("Unable to create the surface: %s\n", SDL_GetError());
+        return 1;
+    }
+    Lightmap lightmap;
+    if (!init_lightmap(&lightmap, BENCH_LEVEL_W, BENCH_H, BENCH_W, BENCH_H, LIGHT_AMBIENT)) {
+        printf("Out of memory for the lightmap\n");
+        SDL_FreeSurface(screen);
+        return 1;
+    }
+    for (int i = 0; i < BENCH_LANTERNS; i++) {
+        Light lantern = {i * BENCH_LEVEL_W / BENCH_LANTERNS + 200, BENCH_H / 2, 250, 255, 200, 120};
+        lightmap_add_static(&lightmap, lantern);
+    }
+    Camera camera;
+    init_camera(&camera, BENCH_W, BENCH_H, BENCH_LEVEL_W, BENCH_H);
+    Uint32 gray = SDL_MapRGB(screen->format, 192, 192, 192);
+
+    clock_t applyTime = 0;
+    for (int f = -1; f < frames; f++) {
+        if (camera.x + BENCH_W >= BENCH_LEVEL_W) camera_move(&camera, -BENCH_LEVEL_W, 0);
+        camera_move(&camera, BENCH_SCROLL, 0);
+        SDL_FillRect(screen, NULL, gray);
+
+        // Player torch, an enemy glow and two sparks, all in view
+        Light torch = {camera.x + 640, 400, 200, 255, 255, 220};
+        Light glow = {camera.x + 900, 300, 80, 80, 160, 255};
+        Light spark1 = {camera.x + 300, 500, 60, 255, 140, 40};
+        Light spark2 = {camera.x + 1100, 200, 60, 255, 140, 40};
+        lightmap_add_dynamic(&lightmap, torch);
+        lightmap_add_dynamic(&lightmap, glow);
+        lightmap_add_dynamic(&lightmap, spark1);
+        lightmap_add_dynamic(&lightmap, spark2);
+
+        // Frame -1 builds the static cache and is not timed
+        clock_t t0 = clock();
+        lightmap_apply(&lightmap, screen, &camera);
+        if (f >= 0) applyTime += clock() - t0;
+    }
+
+#ifdef __SSE2__
+    const char *build = "SSE2";
+#else
+    const char *build = "scalar";
+#endif
+    double applyMs = 1000.0 * applyTime / CLOCKS_PER_SEC / frames;
+    printf("lightmap (%s): %dx%d view, %d static + 4 dynamic lights, apply %.3f ms/frame (%.2f ns per pixel)\n",
+           build, BENCH_W, BENCH_H, BENCH_LANTERNS, applyMs, applyMs * 1e6 / (BENCH_W * BENCH_H));
+
+    free_lightmap(&lightmap);
+    SDL_FreeSurface(screen);
+    return 0;
+}
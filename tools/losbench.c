@@ -0,0 +1,93 @@
+// losbench - time collision_line_of_sight on a synthetic level
+//
+// Usage: losbench [queries per round]
+//
+// Builds a collision map from a generated mask (ground plus random platforms,
+// about the size of a long level), then times line of sight checks between random
+// free points at most BENCH_RANGE apart, like enemies looking for the player.
+// Prints the cost per query and how many fit in one 60 FPS frame.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <SDL/SDL.h>
+#include "collision.h"
+
+#define BENCH_LEVEL_W 8192
+#define BENCH_LEVEL_H 1024
+#define BENCH_PLATFORMS 400
+#define BENCH_RANGE 600           // Max distance between the two points of a query
+#define BENCH_MIN_SECONDS 1.0     // Rounds are repeated until this much time is spent
+
+int main(int argc, char *argv[]) {
+    int queries = argc > 1 ? atoi(argv[1]) : 100000;
+    if (queries <= 0) {
+        printf("Invalid query count %s\n", argv[1]);
+        return 1;
+    }
+
+    // Black is free, anything else is solid
+    SDL_Surface *mask = SDL_CreateRGBSurface(SDL_SWSURFACE, BENCH_LEVEL_W, BENCH_LEVEL_H, 32,
+                                             0xFF0000, 0x00FF00, 0x0000FF, 0);
+    if (!mask) {
+        printf("Unable to create the mask: %s\n", SDL_GetError());
+        return 1;
+    }
+    Uint32 wall = SDL_MapRGB(mask->format, 255, 255, 255);
+    SDL_FillRect(mask, NULL, SDL_MapRGB(mask->format, 0, 0, 0));
+    srand(1234);
+    SDL_Rect ground = {0, BENCH_LEVEL_H - 64, BENCH_LEVEL_W, 64};
+    SDL_FillRect(mask, &ground, wall);
+    for (int i = 0; i < BENCH_PLATFORMS; i++) {
+        SDL_Rect platform = {rand() % BENCH_LEVEL_W, rand() % (BENCH_LEVEL_H - 64),
+                             64 + rand() % 448, 8 + rand() % 24};
+        SDL_FillRect(mask, &platform, wall);
+    }
+
+    CollisionMap map;
+    if (!init_collision_map(&map, mask)) {
+        printf("Out of memory for the collision map\n");
+        SDL_FreeSurface(mask);
+        return 1;
+    }
+    SDL_FreeSurface(mask);
+
+    // Random query segments, generated once so only the checks are timed
+    int *points = malloc(sizeof(int) * 4 * queries);
+    if (!points) {
+        printf("Out of memory for %d queries\n", queries);
+        free_collision_map(&map);
+        return 1;
+    }
+    // Both ends in free space, like an enemy and the player
+    for (int i = 0; i < queries; i++) {
+        int *q = points + i * 4;
+        do {
+            q[0] = rand() % BENCH_LEVEL_W;
+            q[1] = rand() % BENCH_LEVEL_H;
+            q[2] = q[0] + rand() % (2 * BENCH_RANGE + 1) - BENCH_RANGE;
+            q[3] = q[1] + rand() % (2 * BENCH_RANGE + 1) - BENCH_RANGE;
+        } while (collision_solid(&map, q[0], q[1]) || collision_solid(&map, q[2], q[3]));
+    }
+
+    long total = 0;
+    long visible = 0;
+    clock_t start = clock();
+    double seconds = 0;
+    do {
+        for (int i = 0; i < queries; i++) {
+            const int *q = points + i * 4;
+            visible += collision_line_of_sight(&map, q[0], q[1], q[2], q[3]);
+        }
+        total += queries;
+        seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    } while (seconds < BENCH_MIN_SECONDS);
+
+    double ns = seconds * 1e9 / total;
+    printf("collision_line_of_sight: %ld queries, %.1f ns/query, %.0f queries per 16 ms frame (%.1f%% clear)\n",
+           total, ns, 16e6 / ns, 100.0 * visible / total);
+
+    free(points);
+    free_collision_map(&map);
+    return 0;
+}
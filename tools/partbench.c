@@ -0,0 +1,74 @@
+// partbench - time the particle update and draw on a full particle buffer
+//
+// Usage: partbench [frames]
+//
+// Fills all PARTICLE_CAPACITY particles in the middle of a 1280x720 32-bit surface,
+// then times update_particles and draw_particles frame by frame (16 ms steps).
+// The buffer is refilled between rounds so every timed frame runs at full capacity.
+// Built twice by "make bench": with SSE2 and with the scalar fallback (-mno-sse2).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <SDL/SDL.h>
+#include "particles.h"
+
+#define BENCH_W 1280
+#define BENCH_H 720
+#define BENCH_ROUND 30            // Frames per round, short enough for no particle to die
+#define BENCH_LIFE 5000           // ms
+
+int main(int argc, char *argv[]) {
+    int frames = argc > 1 ? atoi(argv[1]) : 600;
+    if (frames <= 0) {
+        printf("Invalid frame count %s\n", argv[1]);
+        return 1;
+    }
+
+    SDL_Surface *screen = SDL_CreateRGBSurface(SDL_SWSURFACE, BENCH_W, BENCH_H, 32,
+                                               0xFF0000, 0x00FF00, 0x0000FF, 0);
+    if (!screen) {
+        printf("Unable to create the surface: %s\n", SDL_GetError());
+        return 1;
+    }
+    if (!init_particles(PARTICLE_CAPACITY)) {
+        SDL_FreeSurface(screen);
+        return 1;
+    }
+    Camera camera;
+    init_camera(&camera, BENCH_W, BENCH_H, 0, 0);
+    srand(1234);
+
+    clock_t updateTime = 0;
+    clock_t drawTime = 0;
+    for (int f = 0; f < frames; f++) {
+        if (f % BENCH_ROUND == 0) {
+            clear_particles();
+            emit_particles(BENCH_W / 2, BENCH_H / 3, PARTICLE_CAPACITY, 300, PARTICLE_SPARK, BENCH_LIFE);
+            SDL_FillRect(screen, NULL, 0);
+        }
+
+        clock_t t0 = clock();
+        update_particles(16);
+        clock_t t1 = clock();
+        draw_particles(screen, &camera);
+        clock_t t2 = clock();
+        updateTime += t1 - t0;
+        drawTime += t2 - t1;
+    }
+
+#ifdef __SSE2__
+    const char *build = "SSE2";
+#else
+    const char *build = "scalar";
+#endif
+    double updateMs = 1000.0 * updateTime / CLOCKS_PER_SEC / frames;
+    double drawMs = 1000.0 * drawTime / CLOCKS_PER_SEC / frames;
+    printf("particles (%s): %d particles, update %.3f ms/frame (%.2f ns each), draw %.3f ms/frame (%.2f ns each)\n",
+           build, PARTICLE_CAPACITY, updateMs, updateMs * 1e6 / PARTICLE_CAPACITY,
+           drawMs, drawMs * 1e6 / PARTICLE_CAPACITY);
+
+    free_particles();
+    SDL_FreeSurface(screen);
+    return 0;
+}
@@ -0,0 +1,59 @@
+// sheetpack - generate sprite sheet metadata (.sheet) from a grid sprite sheet
+//
+// Usage: sheetpack <sheet.png> <columns> <rows> [anim names, one per row...]
+//
+// Each grid cell is trimmed to its opaque bounds and written as a frame with its
+// trim offset, so the game only blits visible pixels. Rows become animations,
+// named from the command line ("idle walk run ...") or "row0", "row1"... by default.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <SDL/SDL.h>
+#include <SDL/SDL_image.h>
+#include "spritesheet.h"
+
+int main(int argc, char *argv[]) {
+    if (argc < 4) {
+        printf("Usage: %s <sheet.png> <columns> <rows> [anim names...]\n", argv[0]);
+        return 1;
+    }
+
+    int cols = atoi(argv[2]);
+    int rows = atoi(argv[3]);
+    if (cols <= 0 || rows <= 0) {
+        printf("Invalid grid size %sx%s\n", argv[2], argv[3]);
+        return 1;
+    }
+
+    // No video mode needed: the image is only read, never blitted
+    SDL_Surface *image = IMG_Load(argv[1]);
+    if (!image) {
+        printf("Unable to load %s: %s\n", argv[1], IMG_GetError());
+        return 1;
+    }
+
+    SpriteSheet sheet;
+    spritesheet_from_grid(&sheet, image, cols, rows);
+
+    // Optional animation names, one per row
+    for (int i = 4; i < argc && i - 4 < sheet.anim_count; i++) {
+        snprintf(sheet.anims[i - 4].name, SPRITE_ANIM_NAME_LEN, "%s", argv[i]);
+    }
+
+    // Report how much blit area trimming saves
+    long cellArea = (long)sheet.cell_w * sheet.cell_h * sheet.frame_count;
+    long trimmedArea = 0;
+    for (int i = 0; i < sheet.frame_count; i++) {
+        trimmedArea += (long)sheet.frames[i].src.w * sheet.frames[i].src.h;
+    }
+
+    char metaPath[256];
+    spritesheet_meta_path(argv[1], metaPath, sizeof(metaPath));
+    int ok = save_spritesheet_meta(&sheet, metaPath);
+    if (ok) {
+        printf("%s: %d frames, blit area %ld -> %ld pixels\n", metaPath, sheet.frame_count, cellArea, trimmedArea);
+    }
+
+    SDL_FreeSurface(image);
+    return ok ? 0 : 1;
+}